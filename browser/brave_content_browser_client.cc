@@ -89,8 +89,11 @@ using extensions::ChromeContentBrowserClientExtensionsPart;
 #endif
 
 #if BUILDFLAG(ENABLE_SPEEDREADER)
+#include "brave/browser/speedreader/speedreader_service_factory.h"
 #include "brave/browser/speedreader/speedreader_tab_helper.h"
+#include "brave/components/speedreader/speedreader_service.h"
 #include "brave/components/speedreader/speedreader_throttle.h"
+#include "content/public/browser/storage_partition.h"
 #include "third_party/blink/public/mojom/loader/resource_load_info.mojom-shared.h"
 #endif
 
@@ -281,8 +284,14 @@ BraveContentBrowserClient::CreateURLLoaderThrottles(
   if (tab_helper && tab_helper->IsActiveForMainFrame()
       && request.resource_type
           == static_cast<int>(blink::mojom::ResourceType::kMainFrame)) {
+    auto* speedreader_service =
+        speedreader::SpeedreaderServiceFactory::GetForProfile(
+            Profile::FromBrowserContext(browser_context));
     result.push_back(std::make_unique<speedreader::SpeedReaderThrottle>(
         g_brave_browser_process->speedreader_rewriter_service(),
+        speedreader_service->distilled_page_cache(),
+        content::BrowserContext::GetDefaultStoragePartition(browser_context)
+            ->GetCookieManagerForBrowserProcess(),
         base::ThreadTaskRunnerHandle::Get()));
   }
 #endif  // ENABLE_SPEEDREADER
@@ -0,0 +1,154 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/path_service.h"
+#include "base/strings/string_split.h"
+#include "base/strings/stringprintf.h"
+#include "base/task/post_task.h"
+#include "base/test/thread_test_helper.h"
+#include "brave/browser/brave_browser_process_impl.h"
+#include "brave/browser/brave_content_browser_client.h"
+#include "brave/browser/extensions/brave_base_local_data_files_browsertest.h"
+#include "brave/common/brave_paths.h"
+#include "brave/common/pref_names.h"
+#include "brave/components/brave_shields/browser/brave_shields_util.h"
+#include "chrome/browser/content_settings/host_content_settings_map_factory.h"
+#include "chrome/browser/extensions/extension_browsertest.h"
+#include "chrome/browser/ui/browser.h"
+#include "chrome/common/chrome_content_client.h"
+#include "chrome/test/base/in_process_browser_test.h"
+#include "chrome/test/base/ui_test_utils.h"
+#include "components/prefs/pref_service.h"
+#include "content/public/browser/render_frame_host.h"
+#include "content/public/test/browser_test.h"
+#include "content/public/test/browser_test_utils.h"
+#include "net/dns/mock_host_resolver.h"
+
+using brave_shields::ControlType;
+
+const char kEmbeddedTestServerDirectory[] = "canvas";
+const char kTitleScript[] = "domAutomationController.send(document.title);";
+
+class BraveCanvasFarblingBrowserTest : public InProcessBrowserTest {
+ public:
+  void SetUpOnMainThread() override {
+    InProcessBrowserTest::SetUpOnMainThread();
+
+    content_client_.reset(new ChromeContentClient);
+    content::SetContentClient(content_client_.get());
+    browser_content_client_.reset(new BraveContentBrowserClient());
+    content::SetBrowserClientForTesting(browser_content_client_.get());
+
+    host_resolver()->AddRule("*", "127.0.0.1");
+    content::SetupCrossSiteRedirector(embedded_test_server());
+
+    brave::RegisterPathProvider();
+    base::FilePath test_data_dir;
+    base::PathService::Get(brave::DIR_TEST_DATA, &test_data_dir);
+    test_data_dir = test_data_dir.AppendASCII(kEmbeddedTestServerDirectory);
+    embedded_test_server()->ServeFilesFromDirectory(test_data_dir);
+
+    ASSERT_TRUE(embedded_test_server()->Start());
+
+    top_level_page_url_ = embedded_test_server()->GetURL("a.com", "/");
+  }
+
+  void TearDown() override {
+    browser_content_client_.reset();
+    content_client_.reset();
+  }
+
+  HostContentSettingsMap* content_settings() {
+    return HostContentSettingsMapFactory::GetForProfile(browser()->profile());
+  }
+
+  void AllowFingerprinting() {
+    brave_shields::SetFingerprintingControlType(
+        content_settings(), ControlType::ALLOW, top_level_page_url_);
+  }
+
+  void BlockFingerprinting() {
+    brave_shields::SetFingerprintingControlType(
+        content_settings(), ControlType::BLOCK, top_level_page_url_);
+  }
+
+  void SetFingerprintingDefault() {
+    brave_shields::SetFingerprintingControlType(
+        content_settings(), ControlType::DEFAULT, top_level_page_url_);
+  }
+
+  template <typename T>
+  std::string ExecScriptGetStr(const std::string& script, T* frame) {
+    std::string value;
+    EXPECT_TRUE(ExecuteScriptAndExtractString(frame, script, &value));
+    return value;
+  }
+
+  content::WebContents* contents() {
+    return browser()->tab_strip_model()->GetActiveWebContents();
+  }
+
+  bool NavigateToURLUntilLoadStop(const GURL& url) {
+    ui_test_utils::NavigateToURL(browser(), url);
+    return WaitForLoadStop(contents());
+  }
+
+ private:
+  GURL top_level_page_url_;
+  std::unique_ptr<ChromeContentClient> content_client_;
+  std::unique_ptr<BraveContentBrowserClient> browser_content_client_;
+};
+
+// Reads back 256x256, 1024x1024 and 4096x4096 canvases through getImageData
+// and toDataURL at every farbling level. Checks that the farbled output is
+// stable for the same domain and image, that reading back part of a canvas
+// returns the same pixels as a full read back, and that farbling changes the
+// unfarbled output. Logs how long the read backs took.
+IN_PROC_BROWSER_TEST_F(BraveCanvasFarblingBrowserTest, FarbleLargeCanvas) {
+  const struct {
+    const char* name;
+    void (BraveCanvasFarblingBrowserTest::*set_level)();
+    bool farbled;
+  } kLevels[] = {
+      {"off", &BraveCanvasFarblingBrowserTest::AllowFingerprinting, false},
+      {"maximum", &BraveCanvasFarblingBrowserTest::BlockFingerprinting, true},
+      {"balanced", &BraveCanvasFarblingBrowserTest::SetFingerprintingDefault,
+       true},
+  };
+  const int kSizes[] = {256, 1024, 4096};
+  // checksums of the pixels and data URL read back with farbling off
+  std::map<int, std::pair<std::string, std::string>> unfarbled;
+  for (const auto& level : kLevels) {
+    (this->*level.set_level)();
+    for (int size : kSizes) {
+      GURL url = embedded_test_server()->GetURL(
+          "a.com",
+          base::StringPrintf("/getimagedata-large-farbling.html?size=%d",
+                             size));
+      NavigateToURLUntilLoadStop(url);
+      std::vector<std::string> result =
+          base::SplitString(ExecScriptGetStr(kTitleScript, contents()), ":",
+                            base::TRIM_WHITESPACE, base::SPLIT_WANT_ALL);
+      ASSERT_EQ(5u, result.size());
+      EXPECT_EQ("stable", result[0]);
+      EXPECT_EQ("consistent", result[1]);
+      const auto checksums = std::make_pair(result[2], result[3]);
+      if (!level.farbled) {
+        unfarbled[size] = checksums;
+      } else {
+        ASSERT_EQ(1u, unfarbled.count(size));
+        EXPECT_NE(unfarbled[size].first, checksums.first);
+        EXPECT_NE(unfarbled[size].second, checksums.second);
+      }
+      LOG(INFO) << "Farbling level " << level.name << ": read back " << size
+                << "x" << size << " canvas 4 times in " << result[4] << " ms";
+    }
+  }
+}
@@ -4,6 +4,7 @@
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "base/path_service.h"
+#include "base/strings/string_split.h"
 #include "base/strings/stringprintf.h"
 #include "base/task/post_task.h"
 #include "base/test/thread_test_helper.h"
@@ -183,3 +184,19 @@ IN_PROC_BROWSER_TEST_F(BraveNavigatorUserAgentFarblingBrowserTest,
   std::string off_ua_b2 = ExecScriptGetStr(kUserAgentScript, contents());
   EXPECT_EQ(off_ua_b, off_ua_b2);
 }
+
+// Tests that hundreds of same-site iframes all see the same farbled user agent
+// and logs how long it took to set them up
+IN_PROC_BROWSER_TEST_F(BraveNavigatorUserAgentFarblingBrowserTest,
+                       FarbleNavigatorUserAgentManyIframes) {
+  std::string domain_b = "b.com";
+  BlockFingerprinting(domain_b);
+  NavigateToURLUntilLoadStop(embedded_test_server()->GetURL(
+      domain_b, "/navigator/ua-many-iframes.html"));
+  std::vector<std::string> result = base::SplitString(
+      content::EvalJs(contents(), "framesReported").ExtractString(), ":",
+      base::TRIM_WHITESPACE, base::SPLIT_WANT_ALL);
+  ASSERT_EQ(2u, result.size());
+  EXPECT_EQ("pass", result[0]);
+  LOG(INFO) << "Set up 300 same-site iframes in " << result[1] << " ms";
+}
@@ -3,7 +3,15 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this file,
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+#include "base/bind.h"
 #include "base/path_service.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
 #include "base/strings/stringprintf.h"
 #include "base/task/post_task.h"
 #include "base/test/thread_test_helper.h"
@@ -24,6 +32,7 @@
 #include "content/public/browser/render_frame_host.h"
 #include "content/public/test/browser_test.h"
 #include "content/public/test/browser_test_utils.h"
+#include "crypto/hmac.h"
 #include "net/dns/mock_host_resolver.h"
 
 using brave_shields::ControlType;
@@ -31,6 +40,69 @@ using brave_shields::ControlType;
 const char kEmbeddedTestServerDirectory[] = "webaudio";
 const char kTitleScript[] = "domAutomationController.send(document.title);";
 
+// Renderers launched by browser tests always use this session token.
+const uint64_t kTestSessionToken = 12345;
+
+namespace {
+
+// The per-sample farbling callbacks as they were before channels were farbled
+// in bulk, used as the reference for the bulk implementation.
+uint64_t lfsr_next(uint64_t v) {
+  const uint64_t zero = 0;
+  return ((v >> 1) | (((v << 62) ^ (v << 61)) & (~(~zero << 63) << 62)));
+}
+
+float Identity(float value, size_t index) {
+  return value;
+}
+
+float ConstantMultiplier(double fudge_factor, float value, size_t index) {
+  return value * fudge_factor;
+}
+
+float PseudoRandomSequence(uint64_t seed, float value, size_t index) {
+  static uint64_t v;
+  const double maxUInt64AsDouble = UINT64_MAX;
+  if (index == 0)
+    v = seed;
+  v = lfsr_next(v);
+  return (v / maxUInt64AsDouble) / 10;
+}
+
+// Farbles the samples of largeBuffer.html one at a time for |domain| and
+// returns the same checksum the page computes over its farbled samples.
+std::string GetExpectedLargeBufferChecksum(const std::string& domain,
+                                           const char* level) {
+  uint64_t domain_key[4];
+  crypto::HMAC h(crypto::HMAC::SHA256);
+  CHECK(h.Init(reinterpret_cast<const unsigned char*>(&kTestSessionToken),
+               sizeof kTestSessionToken));
+  CHECK(h.Sign(domain, reinterpret_cast<unsigned char*>(domain_key),
+               sizeof domain_key));
+
+  base::RepeatingCallback<float(float, size_t)> farble =
+      base::BindRepeating(&Identity);
+  if (strcmp(level, "balanced") == 0) {
+    const double maxUInt64AsDouble = UINT64_MAX;
+    double fudge_factor = 0.99 + ((domain_key[0] / maxUInt64AsDouble) / 100);
+    farble = base::BindRepeating(&ConstantMultiplier, fudge_factor);
+  } else if (strcmp(level, "maximum") == 0) {
+    farble = base::BindRepeating(&PseudoRandomSequence, domain_key[0]);
+  }
+
+  uint32_t hash = 0x811c9dc5;
+  const size_t length = 48000 * 30;
+  for (size_t i = 0; i < length; i++) {
+    const float value = farble.Run(static_cast<float>((i % 1000) / 1000.0), i);
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof bits);
+    hash = (hash ^ bits) * 0x01000193;
+  }
+  return base::NumberToString(hash);
+}
+
+}  // namespace
+
 class BraveWebAudioFarblingBrowserTest : public InProcessBrowserTest {
  public:
   void SetUpOnMainThread() override {
@@ -56,6 +128,8 @@ class BraveWebAudioFarblingBrowserTest : public InProcessBrowserTest {
     farbling_url_ = embedded_test_server()->GetURL("a.com", "/farbling.html");
     copy_from_channel_url_ =
         embedded_test_server()->GetURL("a.com", "/copyFromChannel.html");
+    large_buffer_url_ =
+        embedded_test_server()->GetURL("a.com", "/largeBuffer.html");
   }
 
   void TearDown() override {
@@ -67,6 +141,8 @@ class BraveWebAudioFarblingBrowserTest : public InProcessBrowserTest {
 
   const GURL& farbling_url() { return farbling_url_; }
 
+  const GURL& large_buffer_url() { return large_buffer_url_; }
+
   HostContentSettingsMap* content_settings() {
     return HostContentSettingsMapFactory::GetForProfile(browser()->profile());
   }
@@ -106,6 +182,7 @@ class BraveWebAudioFarblingBrowserTest : public InProcessBrowserTest {
   GURL top_level_page_url_;
   GURL copy_from_channel_url_;
   GURL farbling_url_;
+  GURL large_buffer_url_;
   std::unique_ptr<ChromeContentClient> content_client_;
   std::unique_ptr<BraveContentBrowserClient> browser_content_client_;
 };
@@ -142,3 +219,32 @@ IN_PROC_BROWSER_TEST_F(BraveWebAudioFarblingBrowserTest, FarbleWebAudio) {
   NavigateToURLUntilLoadStop(farbling_url());
   EXPECT_EQ(ExecScriptGetStr(kTitleScript, contents()), "8000");
 }
+
+// Farbles a 30 second buffer through both copyFromChannel and getChannelData
+// at every farbling level, checks that both paths agree sample for sample and
+// that the bulk farbling matches the per-sample farbling it replaced for the
+// same session key, and logs how long farbling took.
+IN_PROC_BROWSER_TEST_F(BraveWebAudioFarblingBrowserTest,
+                       FarbleWebAudioLargeBuffer) {
+  const struct {
+    const char* name;
+    void (BraveWebAudioFarblingBrowserTest::*set_level)();
+  } kLevels[] = {
+      {"maximum", &BraveWebAudioFarblingBrowserTest::BlockFingerprinting},
+      {"balanced", &BraveWebAudioFarblingBrowserTest::SetFingerprintingDefault},
+      {"off", &BraveWebAudioFarblingBrowserTest::AllowFingerprinting},
+  };
+  for (const auto& level : kLevels) {
+    (this->*level.set_level)();
+    NavigateToURLUntilLoadStop(large_buffer_url());
+    std::vector<std::string> result =
+        base::SplitString(ExecScriptGetStr(kTitleScript, contents()), ":",
+                          base::TRIM_WHITESPACE, base::SPLIT_WANT_ALL);
+    ASSERT_EQ(3u, result.size());
+    EXPECT_EQ("identical", result[0]);
+    EXPECT_EQ(GetExpectedLargeBufferChecksum("a.com", level.name), result[1])
+        << "Farbling level " << level.name;
+    LOG(INFO) << "Farbling level " << level.name << ": farbled 2 x 1440000 "
+              << "samples in " << result[2] << " ms";
+  }
+}
@@ -110,3 +110,38 @@ IN_PROC_BROWSER_TEST_F(SpeedReaderBrowserTest, P3ATest) {
   tester.ExpectBucketCount(kSpeedreaderToggleUMAHistogramName, 1, 1);
   tester.ExpectBucketCount(kSpeedreaderToggleUMAHistogramName, 2, 0);
 }
+
+class SpeedReaderBufferingBrowserTest : public SpeedReaderBrowserTest {
+ public:
+  SpeedReaderBufferingBrowserTest() {
+    buffering_feature_list_.InitAndDisableFeature(
+        speedreader::kSpeedreaderStreamingFeature);
+  }
+
+ private:
+  base::test::ScopedFeatureList buffering_feature_list_;
+};
+
+// Streaming and buffering distillation must deliver the same page.
+IN_PROC_BROWSER_TEST_F(SpeedReaderBufferingBrowserTest,
+                       StreamingMatchesBuffering) {
+  chrome::ExecuteCommand(browser(), IDC_TOGGLE_SPEEDREADER);
+  const GURL url = https_server_.GetURL(kTestHost, kTestPage);
+  ui_test_utils::NavigateToURL(browser(), url);
+  content::WebContents* contents =
+      browser()->tab_strip_model()->GetActiveWebContents();
+  const std::string buffered =
+      content::EvalJs(contents->GetMainFrame(),
+                      "document.documentElement.outerHTML")
+          .ExtractString();
+  EXPECT_FALSE(buffered.empty());
+
+  {
+    base::test::ScopedFeatureList streaming_feature_list;
+    streaming_feature_list.InitAndEnableFeature(
+        speedreader::kSpeedreaderStreamingFeature);
+    ui_test_utils::NavigateToURL(browser(), url);
+    EXPECT_EQ(buffered, content::EvalJs(contents->GetMainFrame(),
+                                        "document.documentElement.outerHTML"));
+  }
+}
@@ -5,6 +5,7 @@
 
 #include "brave/browser/speedreader/speedreader_service_factory.h"
 
+#include "base/files/file_path.h"
 #include "brave/components/speedreader/speedreader_service.h"
 #include "chrome/browser/profiles/incognito_helpers.h"
 #include "chrome/browser/profiles/profile.h"
@@ -38,8 +39,12 @@ SpeedreaderServiceFactory::GetBrowserContextToUse(
 
 KeyedService* SpeedreaderServiceFactory::BuildServiceInstanceFor(
     content::BrowserContext* context) const {
+  // Distilled pages from off-the-record profiles are never written to disk.
   return new SpeedreaderService(
-      Profile::FromBrowserContext(context)->GetPrefs());
+      Profile::FromBrowserContext(context)->GetPrefs(),
+      context->IsOffTheRecord()
+          ? base::FilePath()
+          : context->GetPath().Append(FILE_PATH_LITERAL("Speedreader Cache")));
 }
 
 bool SpeedreaderServiceFactory::ServiceIsCreatedWithBrowserContext() const {
@@ -5,8 +5,20 @@
 
 #include "third_party/blink/renderer/core/execution_context/execution_context.h"
 
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+
 #include "base/command_line.h"
+#include "base/containers/mru_cache.h"
+#include "base/memory/ref_counted.h"
+#include "base/no_destructor.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
 #include "brave/third_party/blink/renderer/brave_farbling_constants.h"
 #include "crypto/hmac.h"
 #include "third_party/blink/public/platform/web_content_settings_client.h"
@@ -15,9 +27,6 @@
 #include "third_party/blink/renderer/core/frame/local_frame.h"
 #include "third_party/blink/renderer/core/workers/worker_global_scope.h"
 #include "third_party/blink/renderer/platform/bindings/script_state.h"
-#include "third_party/blink/renderer/platform/graphics/image_data_buffer.h"
-#include "third_party/blink/renderer/platform/graphics/static_bitmap_image.h"
-#include "third_party/blink/renderer/platform/graphics/unaccelerated_static_bitmap_image.h"
 #include "third_party/blink/renderer/platform/heap/handle.h"
 #include "third_party/blink/renderer/platform/network/network_utils.h"
 #include "third_party/blink/renderer/platform/supplementable.h"
@@ -31,27 +40,7 @@ inline uint64_t lfsr_next(uint64_t v) {
   return ((v >> 1) | (((v << 62) ^ (v << 61)) & (~(~zero << 63) << 62)));
 }
 
-float Identity(float value, size_t index) {
-  return value;
-}
-
-float ConstantMultiplier(double fudge_factor, float value, size_t index) {
-  return value * fudge_factor;
-}
-
-float PseudoRandomSequence(uint64_t seed, float value, size_t index) {
-  static uint64_t v;
-  const double maxUInt64AsDouble = UINT64_MAX;
-  if (index == 0) {
-    // start of loop, reset to initial seed which was passed in and is based on
-    // the domain key
-    v = seed;
-  }
-  // get next value in PRNG sequence
-  v = lfsr_next(v);
-  // return pseudo-random float between 0 and 0.1
-  return (v / maxUInt64AsDouble) / 10;
-}
+const double kMaxUInt64AsDouble = UINT64_MAX;
 
 }  // namespace
 
@@ -61,12 +50,165 @@ const char kBraveSessionToken[] = "brave_session_token";
 const char BraveSessionCache::kSupplementName[] = "BraveSessionCache";
 const int kFarbledUserAgentMaxExtraSpaces = 5;
 
+// canvases whose hashed pixel data is at most this many bytes are hashed in
+// full; larger ones are hashed over kCanvasSampleChunkCount chunks of
+// kCanvasSampleChunkSize bytes
+const size_t kCanvasFullHashMaxBytes = 256 * 256;
+const size_t kCanvasSampleChunkCount = 1024;
+const size_t kCanvasSampleChunkSize = 64;
+
+// number of (session token, domain) entries kept by LookUpFarblingTokens()
+const size_t kMaxCachedFarblingTokens = 32;
+
 // acceptable letters for generating random strings
 const char kLettersForRandomStrings[] =
     "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789. ";
 // length of kLettersForRandomStrings array
 const size_t kLettersForRandomStringsLength = 64;
 
+AudioFarbler::AudioFarbler() : AudioFarbler(Mode::kIdentity, 1.0, 0) {}
+
+AudioFarbler::AudioFarbler(Mode mode, double fudge_factor, uint64_t seed)
+    : mode_(mode), fudge_factor_(fudge_factor), seed_(seed) {}
+
+// static
+AudioFarbler AudioFarbler::ConstantMultiplier(double fudge_factor) {
+  return AudioFarbler(Mode::kConstantMultiplier, fudge_factor, 0);
+}
+
+// static
+AudioFarbler AudioFarbler::PseudoRandomSequence(uint64_t seed) {
+  return AudioFarbler(Mode::kPseudoRandomSequence, 1.0, seed);
+}
+
+void AudioFarbler::FarbleAudioChannel(base::span<float> channel) const {
+  float* data = channel.data();
+  const size_t size = channel.size();
+  switch (mode_) {
+    case Mode::kIdentity:
+      break;
+    case Mode::kConstantMultiplier: {
+      // Plain indexed loop over locals so the compiler can vectorize it. The
+      // multiply is done in double precision to match FarbleSample().
+      const double fudge_factor = fudge_factor_;
+      for (size_t i = 0; i < size; ++i)
+        data[i] = data[i] * fudge_factor;
+      break;
+    }
+    case Mode::kPseudoRandomSequence: {
+      // pseudo-random floats between 0 and 0.1, unrelated to the input
+      uint64_t v = seed_;
+      for (size_t i = 0; i < size; ++i) {
+        v = lfsr_next(v);
+        data[i] = (v / kMaxUInt64AsDouble) / 10;
+      }
+      break;
+    }
+  }
+}
+
+float AudioFarbler::FarbleSample(float value,
+                                 size_t index,
+                                 uint64_t* state) const {
+  switch (mode_) {
+    case Mode::kIdentity:
+      return value;
+    case Mode::kConstantMultiplier:
+      return value * fudge_factor_;
+    case Mode::kPseudoRandomSequence:
+      DCHECK(state);
+      if (index == 0) {
+        // start of loop, reset to initial seed which is based on the domain
+        // key
+        *state = seed_;
+      }
+      // get next value in PRNG sequence
+      *state = lfsr_next(*state);
+      // return pseudo-random float between 0 and 0.1
+      return (*state / kMaxUInt64AsDouble) / 10;
+  }
+  NOTREACHED();
+  return value;
+}
+
+// Values derived from the session token for one top-level eTLD+1. A single
+// instance is shared by every execution context in this renderer process that
+// farbles on behalf of that domain, including contexts on worker threads, so
+// the memoized strings are guarded by |lock_|.
+class FarblingTokens : public base::RefCountedThreadSafe<FarblingTokens> {
+ public:
+  FarblingTokens(uint64_t session_key, const std::string& domain) {
+    crypto::HMAC h(crypto::HMAC::SHA256);
+    CHECK(h.Init(reinterpret_cast<const unsigned char*>(&session_key),
+                 sizeof session_key));
+    CHECK(h.Sign(domain, domain_key_, sizeof domain_key_));
+    Initialize();
+  }
+
+  // Tokens for an already derived |domain_key| of 32 bytes.
+  explicit FarblingTokens(const uint8_t* domain_key) {
+    memcpy(domain_key_, domain_key, sizeof domain_key_);
+    Initialize();
+  }
+
+  const uint8_t* domain_key() const { return domain_key_; }
+  int user_agent_extra_spaces() const { return user_agent_extra_spaces_; }
+
+  std::string GetRandomString(const std::string& seed, wtf_size_t length) {
+    base::AutoLock auto_lock(lock_);
+    auto key = std::make_pair(seed, length);
+    auto it = random_strings_.find(key);
+    if (it != random_strings_.end())
+      return it->second;
+    uint8_t key_bytes[32];
+    crypto::HMAC h(crypto::HMAC::SHA256);
+    CHECK(h.Init(domain_key_, sizeof domain_key_));
+    CHECK(h.Sign(seed, key_bytes, sizeof key_bytes));
+    // initial PRNG seed based on session key and passed-in seed string
+    uint64_t v = *reinterpret_cast<uint64_t*>(key_bytes);
+    std::string value(length, ' ');
+    for (wtf_size_t i = 0; i < length; i++) {
+      value[i] = kLettersForRandomStrings[v % kLettersForRandomStringsLength];
+      v = lfsr_next(v);
+    }
+    random_strings_.emplace(std::move(key), value);
+    return value;
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<FarblingTokens>;
+  ~FarblingTokens() = default;
+
+  void Initialize() {
+    std::mt19937_64 prng(*reinterpret_cast<uint64_t*>(domain_key_));
+    user_agent_extra_spaces_ = prng() % kFarbledUserAgentMaxExtraSpaces;
+  }
+
+  uint8_t domain_key_[32];
+  int user_agent_extra_spaces_;
+  base::Lock lock_;
+  std::map<std::pair<std::string, wtf_size_t>, std::string> random_strings_
+      GUARDED_BY(lock_);
+};
+
+// Returns the tokens for |domain|, deriving them only the first time any
+// execution context in this process asks for them.
+scoped_refptr<FarblingTokens> LookUpFarblingTokens(uint64_t session_key,
+                                                   const std::string& domain) {
+  using TokensCache = base::MRUCache<std::pair<uint64_t, std::string>,
+                                     scoped_refptr<FarblingTokens>>;
+  static base::NoDestructor<base::Lock> lock;
+  static base::NoDestructor<TokensCache> cache(kMaxCachedFarblingTokens);
+  base::AutoLock auto_lock(*lock);
+  const auto key = std::make_pair(session_key, domain);
+  auto it = cache->Get(key);
+  if (it != cache->end())
+    return it->second;
+  auto tokens = base::MakeRefCounted<FarblingTokens>(session_key, domain);
+  cache->Put(key, tokens);
+  return tokens;
+}
+
 blink::WebContentSettingsClient* GetContentSettingsClientFor(
     ExecutionContext* context) {
   blink::WebContentSettingsClient* settings = nullptr;
@@ -88,6 +230,8 @@ blink::WebContentSettingsClient* GetContentSettingsClientFor(
 BraveSessionCache::BraveSessionCache(ExecutionContext& context)
     : Supplement<ExecutionContext>(context) {
   farbling_enabled_ = false;
+  session_key_ = 0;
+  memset(domain_key_, 0, sizeof domain_key_);
   scoped_refptr<const blink::SecurityOrigin> origin;
   if (auto* window = blink::DynamicTo<blink::LocalDOMWindow>(context)) {
     auto* frame = window->GetFrame();
@@ -113,13 +257,13 @@ BraveSessionCache::BraveSessionCache(ExecutionContext& context)
   DCHECK(cmd_line->HasSwitch(kBraveSessionToken));
   base::StringToUint64(cmd_line->GetSwitchValueASCII(kBraveSessionToken),
                        &session_key_);
-  crypto::HMAC h(crypto::HMAC::SHA256);
-  CHECK(h.Init(reinterpret_cast<const unsigned char*>(&session_key_),
-               sizeof session_key_));
-  CHECK(h.Sign(domain, domain_key_, sizeof domain_key_));
+  farbling_tokens_ = LookUpFarblingTokens(session_key_, domain);
+  memcpy(domain_key_, farbling_tokens_->domain_key(), sizeof domain_key_);
   farbling_enabled_ = true;
 }
 
+BraveSessionCache::~BraveSessionCache() = default;
+
 BraveSessionCache& BraveSessionCache::From(ExecutionContext& context) {
   BraveSessionCache* cache =
       Supplement<ExecutionContext>::From<BraveSessionCache>(context);
@@ -130,7 +274,7 @@ BraveSessionCache& BraveSessionCache::From(ExecutionContext& context) {
   return *cache;
 }
 
-AudioFarblingCallback BraveSessionCache::GetAudioFarblingCallback(
+AudioFarbler BraveSessionCache::GetAudioFarbler(
     blink::WebContentSettingsClient* settings) {
   if (farbling_enabled_ && settings) {
     switch (settings->GetBraveFarblingLevel()) {
@@ -139,59 +283,76 @@ AudioFarblingCallback BraveSessionCache::GetAudioFarblingCallback(
       }
       case BraveFarblingLevel::BALANCED: {
         const uint64_t* fudge = reinterpret_cast<const uint64_t*>(domain_key_);
-        const double maxUInt64AsDouble = UINT64_MAX;
-        double fudge_factor = 0.99 + ((*fudge / maxUInt64AsDouble) / 100);
+        double fudge_factor = 0.99 + ((*fudge / kMaxUInt64AsDouble) / 100);
         VLOG(1) << "audio fudge factor (based on session token) = "
                 << fudge_factor;
-        return base::BindRepeating(&ConstantMultiplier, fudge_factor);
+        return AudioFarbler::ConstantMultiplier(fudge_factor);
       }
       case BraveFarblingLevel::MAXIMUM: {
         uint64_t seed = *reinterpret_cast<uint64_t*>(domain_key_);
-        return base::BindRepeating(&PseudoRandomSequence, seed);
+        return AudioFarbler::PseudoRandomSequence(seed);
       }
     }
   }
-  return base::BindRepeating(&Identity);
+  return AudioFarbler();
+}
+
+void BraveSessionCache::FarbleAudioChannel(
+    blink::WebContentSettingsClient* settings,
+    base::span<float> channel) {
+  if (channel.empty())
+    return;
+  GetAudioFarbler(settings).FarbleAudioChannel(channel);
+}
+
+void BraveSessionCache::PerturbPixels(
+    blink::WebContentSettingsClient* settings,
+    base::span<uint8_t> pixels,
+    int width,
+    int height) {
+  PerturbPixels(settings, pixels, width, height, pixels,
+                blink::IntRect(0, 0, width, height));
 }
 
-scoped_refptr<blink::StaticBitmapImage> BraveSessionCache::PerturbPixels(
+void BraveSessionCache::PerturbPixels(
     blink::WebContentSettingsClient* settings,
-    scoped_refptr<blink::StaticBitmapImage> image_bitmap) {
+    base::span<const uint8_t> canvas_pixels,
+    int canvas_width,
+    int canvas_height,
+    base::span<uint8_t> pixels,
+    const blink::IntRect& rect) {
+  if (!ShouldPerturbPixels(settings))
+    return;
+  PerturbPixelsInternal(canvas_pixels, canvas_width, canvas_height, pixels,
+                        rect);
+}
+
+bool BraveSessionCache::ShouldPerturbPixels(
+    blink::WebContentSettingsClient* settings) {
   if (!farbling_enabled_ || !settings)
-    return image_bitmap;
+    return false;
   switch (settings->GetBraveFarblingLevel()) {
     case BraveFarblingLevel::OFF:
-      break;
+      return false;
     case BraveFarblingLevel::BALANCED:
-    case BraveFarblingLevel::MAXIMUM: {
-      image_bitmap = PerturbPixelsInternal(image_bitmap);
-      break;
-    }
+    case BraveFarblingLevel::MAXIMUM:
+      return true;
     default:
       NOTREACHED();
   }
-  return image_bitmap;
+  return false;
 }
 
-scoped_refptr<blink::StaticBitmapImage>
-BraveSessionCache::PerturbPixelsInternal(
-    scoped_refptr<blink::StaticBitmapImage> image_bitmap) {
-  DCHECK(image_bitmap);
-  if (image_bitmap->IsNull())
-    return image_bitmap;
-  // convert to an ImageDataBuffer to normalize the pixel data to RGBA, 4 bytes
-  // per pixel
-  std::unique_ptr<blink::ImageDataBuffer> data_buffer =
-      blink::ImageDataBuffer::Create(image_bitmap);
-  uint8_t* pixels = const_cast<uint8_t*>(data_buffer->Pixels());
+void BraveSessionCache::ComputeCanvasKey(
+    base::span<const uint8_t> canvas_pixels,
+    int width,
+    int height,
+    uint8_t* canvas_key) {
   // This needs to be type size_t because we pass it to base::StringPiece
   // later for content hashing. This is safe because the maximum canvas
   // dimensions are less than SIZE_T_MAX. (Width and height are each
   // limited to 32,767 pixels.)
-  const size_t pixel_count = data_buffer->Width() * data_buffer->Height();
-  // choose which channel (R, G, or B) to perturb
-  const uint8_t* first_byte = reinterpret_cast<const uint8_t*>(domain_key_);
-  uint8_t channel = *first_byte % 3;
+  const size_t pixel_count = static_cast<size_t>(width) * height;
   // calculate initial seed to find first pixel to perturb, based on session
   // key, domain key, and canvas contents
   crypto::HMAC h(crypto::HMAC::SHA256);
@@ -199,60 +360,96 @@ BraveSessionCache::PerturbPixelsInternal(
       session_key_ ^ *reinterpret_cast<uint64_t*>(domain_key_);
   CHECK(h.Init(reinterpret_cast<const unsigned char*>(&session_plus_domain_key),
                sizeof session_plus_domain_key));
+  if (pixel_count <= kCanvasFullHashMaxBytes) {
+    CHECK(h.Sign(
+        base::StringPiece(reinterpret_cast<const char*>(canvas_pixels.data()),
+                          pixel_count),
+        canvas_key, 32));
+    return;
+  }
+  // Large canvases are only hashed over a bounded, evenly spaced sample of
+  // their pixel data plus their dimensions, so that the cost of farbling
+  // depends on the number of perturbed pixels rather than on canvas size.
+  const size_t stride = canvas_pixels.size() / kCanvasSampleChunkCount;
+  std::string sample;
+  sample.reserve(2 * sizeof(int) +
+                 kCanvasSampleChunkCount * kCanvasSampleChunkSize);
+  const int dimensions[] = {width, height};
+  sample.append(reinterpret_cast<const char*>(dimensions), sizeof dimensions);
+  for (size_t i = 0; i < kCanvasSampleChunkCount; i++) {
+    sample.append(
+        reinterpret_cast<const char*>(canvas_pixels.data() + i * stride),
+        std::min(kCanvasSampleChunkSize, stride));
+  }
+  CHECK(h.Sign(sample, canvas_key, 32));
+}
+
+void BraveSessionCache::PerturbPixelsInternal(
+    base::span<const uint8_t> canvas_pixels,
+    int canvas_width,
+    int canvas_height,
+    base::span<uint8_t> pixels,
+    const blink::IntRect& rect) {
+  const size_t pixel_count = static_cast<size_t>(canvas_width) * canvas_height;
+  if (pixel_count == 0 || rect.IsEmpty())
+    return;
+  DCHECK_EQ(canvas_pixels.size(), 4 * pixel_count);
+  DCHECK_EQ(pixels.size(), 4 * static_cast<size_t>(rect.Width()) *
+                               static_cast<size_t>(rect.Height()));
+  // choose which channel (R, G, or B) to perturb
+  const uint8_t* first_byte = reinterpret_cast<const uint8_t*>(domain_key_);
+  uint8_t channel = *first_byte % 3;
+  // The key is derived from the whole canvas before any of |pixels| are
+  // perturbed, as they may be the same buffer as |canvas_pixels|.
   uint8_t canvas_key[32];
-  CHECK(h.Sign(
-      base::StringPiece(reinterpret_cast<const char*>(pixels), pixel_count),
-      canvas_key, sizeof canvas_key));
+  ComputeCanvasKey(canvas_pixels, canvas_width, canvas_height, canvas_key);
   uint64_t v = *reinterpret_cast<uint64_t*>(canvas_key);
-  uint64_t pixel_index;
   // iterate through 32-byte canvas key and use each bit to determine how to
-  // perturb the current pixel
+  // perturb the current pixel. Pixels are picked in canvas coordinates and
+  // only those inside |rect| are perturbed.
   for (int i = 0; i < 32; i++) {
     uint8_t bit = canvas_key[i];
     for (int j = 8; j >= 0; j--) {
-      pixel_index = 4 * (v % pixel_count) + channel;
-      pixels[pixel_index] = pixels[pixel_index] ^ (bit & 0x1);
+      const uint64_t canvas_index = v % pixel_count;
+      const int x = static_cast<int>(canvas_index % canvas_width);
+      const int y = static_cast<int>(canvas_index / canvas_width);
+      if (rect.Contains(x, y)) {
+        const size_t pixel_index =
+            4 * (static_cast<size_t>(y - rect.Y()) * rect.Width() +
+                 (x - rect.X())) +
+            channel;
+        pixels[pixel_index] = pixels[pixel_index] ^ (bit & 0x1);
+      }
       bit = bit >> 1;
       // find next pixel to perturb
       v = lfsr_next(v);
     }
   }
-  // convert back to a StaticBitmapImage to return to the caller
-  scoped_refptr<blink::StaticBitmapImage> perturbed_bitmap =
-      blink::UnacceleratedStaticBitmapImage::Create(
-          data_buffer->RetainedImage());
-  return perturbed_bitmap;
 }
 
 WTF::String BraveSessionCache::GenerateRandomString(std::string seed,
                                                     wtf_size_t length) {
-  uint8_t key[32];
-  crypto::HMAC h(crypto::HMAC::SHA256);
-  CHECK(h.Init(reinterpret_cast<const unsigned char*>(&domain_key_),
-               sizeof domain_key_));
-  CHECK(h.Sign(seed, key, sizeof key));
-  // initial PRNG seed based on session key and passed-in seed string
-  uint64_t v = *reinterpret_cast<uint64_t*>(key);
-  UChar* destination;
-  WTF::String value = WTF::String::CreateUninitialized(length, destination);
-  for (wtf_size_t i = 0; i < length; i++) {
-    destination[i] =
-        kLettersForRandomStrings[v % kLettersForRandomStringsLength];
-    v = lfsr_next(v);
-  }
-  return value;
+  const std::string value = GetFarblingTokens()->GetRandomString(seed, length);
+  return WTF::String(value.data(), value.size());
 }
 
 WTF::String BraveSessionCache::FarbledUserAgent(WTF::String real_user_agent) {
-  std::mt19937_64 prng = MakePseudoRandomGenerator();
   WTF::StringBuilder result;
   result.Append(real_user_agent);
-  int extra = prng() % kFarbledUserAgentMaxExtraSpaces;
+  int extra = GetFarblingTokens()->user_agent_extra_spaces();
   for (int i = 0; i < extra; i++)
     result.Append(" ");
   return result.ToString();
 }
 
+FarblingTokens* BraveSessionCache::GetFarblingTokens() {
+  // contexts without a farbling domain keep using the all-zero domain key, as
+  // MakePseudoRandomGenerator() does
+  if (!farbling_tokens_)
+    farbling_tokens_ = base::MakeRefCounted<FarblingTokens>(domain_key_);
+  return farbling_tokens_.get();
+}
+
 std::mt19937_64 BraveSessionCache::MakePseudoRandomGenerator() {
   uint64_t seed = *reinterpret_cast<uint64_t*>(domain_key_);
   return std::mt19937_64(seed);
@@ -10,10 +10,10 @@
 
 #include <random>
 
-#include "base/callback.h"
+#include "base/containers/span.h"
+#include "third_party/blink/renderer/platform/geometry/int_rect.h"
 
 namespace blink {
-class StaticBitmapImage;
 class WebContentSettingsClient;
 }  // namespace blink
 
@@ -27,7 +27,38 @@ using blink::TraceTrait;
 
 namespace brave {
 
-typedef base::RepeatingCallback<float(float, size_t)> AudioFarblingCallback;
+// Farbles Web Audio sample data for one execution context. Instances hold no
+// mutable state and are cheap to copy, so they can be handed to the audio
+// thread or to AudioWorklet scopes without synchronization.
+class CORE_EXPORT AudioFarbler {
+ public:
+  AudioFarbler();
+  static AudioFarbler ConstantMultiplier(double fudge_factor);
+  static AudioFarbler PseudoRandomSequence(uint64_t seed);
+
+  bool IsIdentity() const { return mode_ == Mode::kIdentity; }
+
+  // Farbles a whole channel in place. Element |i| of |channel| receives the
+  // same value FarbleSample() would produce for index |i| of a sequence
+  // starting at 0.
+  void FarbleAudioChannel(base::span<float> channel) const;
+
+  // Per-sample variant for callers that need to farble intermediate values
+  // inside their own loops. |state| carries the pseudo-random sequence between
+  // calls and is reset whenever |index| is 0; it must be owned by the caller.
+  float FarbleSample(float value, size_t index, uint64_t* state) const;
+
+ private:
+  enum class Mode { kIdentity, kConstantMultiplier, kPseudoRandomSequence };
+
+  AudioFarbler(Mode mode, double fudge_factor, uint64_t seed);
+
+  Mode mode_;
+  double fudge_factor_;
+  uint64_t seed_;
+};
+
+class FarblingTokens;
 
 CORE_EXPORT blink::WebContentSettingsClient* GetContentSettingsClientFor(
     ExecutionContext* context);
@@ -39,15 +70,33 @@ class CORE_EXPORT BraveSessionCache final
   static const char kSupplementName[];
 
   explicit BraveSessionCache(ExecutionContext&);
-  virtual ~BraveSessionCache() = default;
+  virtual ~BraveSessionCache();
 
   static BraveSessionCache& From(ExecutionContext&);
 
-  AudioFarblingCallback GetAudioFarblingCallback(
-      blink::WebContentSettingsClient* settings);
-  scoped_refptr<blink::StaticBitmapImage> PerturbPixels(
-      blink::WebContentSettingsClient* settings,
-      scoped_refptr<blink::StaticBitmapImage> image_bitmap);
+  AudioFarbler GetAudioFarbler(blink::WebContentSettingsClient* settings);
+  void FarbleAudioChannel(blink::WebContentSettingsClient* settings,
+                          base::span<float> channel);
+  // Returns true if canvas readbacks are perturbed, so that callers can skip
+  // work which is only needed to perturb them.
+  bool ShouldPerturbPixels(blink::WebContentSettingsClient* settings);
+  // Perturbs |pixels|, a whole canvas of |width| x |height| pixels of 4 bytes
+  // each, in place.
+  void PerturbPixels(blink::WebContentSettingsClient* settings,
+                     base::span<uint8_t> pixels,
+                     int width,
+                     int height);
+  // Perturbs |pixels|, the |rect| region of a canvas read back on its own, in
+  // place. The perturbation is derived from |canvas_pixels|, the whole canvas
+  // of |canvas_width| x |canvas_height| pixels, in canvas coordinates, so
+  // every readback of a canvas is perturbed the same way whatever region it
+  // covers.
+  void PerturbPixels(blink::WebContentSettingsClient* settings,
+                     base::span<const uint8_t> canvas_pixels,
+                     int canvas_width,
+                     int canvas_height,
+                     base::span<uint8_t> pixels,
+                     const blink::IntRect& rect);
   WTF::String GenerateRandomString(std::string seed, wtf_size_t length);
   WTF::String FarbledUserAgent(WTF::String real_user_agent);
   std::mt19937_64 MakePseudoRandomGenerator();
@@ -56,9 +105,18 @@ class CORE_EXPORT BraveSessionCache final
   bool farbling_enabled_;
   uint64_t session_key_;
   uint8_t domain_key_[32];
-
-  scoped_refptr<blink::StaticBitmapImage> PerturbPixelsInternal(
-      scoped_refptr<blink::StaticBitmapImage> image_bitmap);
+  scoped_refptr<FarblingTokens> farbling_tokens_;
+
+  FarblingTokens* GetFarblingTokens();
+  void ComputeCanvasKey(base::span<const uint8_t> canvas_pixels,
+                        int width,
+                        int height,
+                        uint8_t* canvas_key);
+  void PerturbPixelsInternal(base::span<const uint8_t> canvas_pixels,
+                             int canvas_width,
+                             int canvas_height,
+                             base::span<uint8_t> pixels,
+                             const blink::IntRect& rect);
 };
 }  // namespace brave
 
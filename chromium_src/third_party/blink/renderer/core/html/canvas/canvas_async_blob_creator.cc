@@ -8,12 +8,21 @@
 #include "third_party/blink/renderer/core/frame/local_dom_window.h"
 #include "third_party/blink/renderer/core/frame/local_frame.h"
 #include "third_party/blink/renderer/core/workers/worker_global_scope.h"
+#include "third_party/blink/renderer/platform/graphics/image_data_buffer.h"
 
-#define BRAVE_CANVAS_ASYNC_BLOB_CREATOR                                       \
-  if (WebContentSettingsClient* settings =                                    \
-          brave::GetContentSettingsClientFor(context)) {                      \
-    image_ = brave::BraveSessionCache::From(*context).PerturbPixels(settings, \
-                                                                    image_);  \
+// |image_| is unaccelerated at this point, so the buffer peeks at its pixels
+// and they are perturbed in place.
+#define BRAVE_CANVAS_ASYNC_BLOB_CREATOR                                    \
+  if (WebContentSettingsClient* settings =                                 \
+          brave::GetContentSettingsClientFor(context)) {                   \
+    if (std::unique_ptr<ImageDataBuffer> data_buffer =                     \
+            ImageDataBuffer::Create(image_)) {                             \
+      brave::BraveSessionCache::From(*context).PerturbPixels(              \
+          settings,                                                        \
+          base::make_span(const_cast<uint8_t*>(data_buffer->Pixels()),     \
+                          data_buffer->ComputeByteSize()),                 \
+          data_buffer->Width(), data_buffer->Height());                    \
+    }                                                                      \
   }
 
 #include "../../../../../../../../third_party/blink/renderer/core/html/canvas/canvas_async_blob_creator.cc"
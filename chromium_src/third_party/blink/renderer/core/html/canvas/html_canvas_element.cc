@@ -9,13 +9,16 @@
 #include "third_party/blink/renderer/core/frame/local_frame.h"
 #include "third_party/blink/renderer/core/workers/worker_global_scope.h"
 
-#define BRAVE_TO_DATA_URL_INTERNAL                                           \
-  if (ExecutionContext* context = GetExecutionContext()) {                   \
-    if (WebContentSettingsClient* settings =                                 \
-            brave::GetContentSettingsClientFor(context)) {                   \
-      image_bitmap = brave::BraveSessionCache::From(*context).PerturbPixels( \
-          settings, image_bitmap);                                           \
-    }                                                                        \
+#define BRAVE_TO_DATA_URL_INTERNAL                                        \
+  if (ExecutionContext* context = GetExecutionContext()) {                \
+    if (WebContentSettingsClient* settings =                              \
+            brave::GetContentSettingsClientFor(context)) {                \
+      brave::BraveSessionCache::From(*context).PerturbPixels(             \
+          settings,                                                       \
+          base::make_span(const_cast<uint8_t*>(data_buffer->Pixels()),    \
+                          data_buffer->ComputeByteSize()),                \
+          data_buffer->Width(), data_buffer->Height());                   \
+    }                                                                     \
   }
 
 #include "../../../../../../../../third_party/blink/renderer/core/html/canvas/html_canvas_element.cc"
@@ -11,20 +11,11 @@
 #include "third_party/blink/renderer/core/frame/local_dom_window.h"
 #include "third_party/blink/renderer/core/frame/local_frame.h"
 #include "third_party/blink/renderer/core/workers/worker_global_scope.h"
+#include "third_party/blink/renderer/platform/graphics/image_data_buffer.h"
 
-#define BRAVE_GET_IMAGE_DATA                                              \
-  if (ExecutionContext* context = ExecutionContext::From(script_state)) { \
-    if (WebContentSettingsClient* settings =                              \
-            brave::GetContentSettingsClientFor(context)) {                \
-      snapshot = brave::BraveSessionCache::From(*context).PerturbPixels(  \
-          settings, snapshot);                                            \
-    }                                                                     \
-  }
-
-#define BRAVE_GET_IMAGE_DATA_PARAMS ScriptState *script_state,
+#define getImageData getImageData_ChromiumImpl
 #include "../../../../../../../../third_party/blink/renderer/modules/canvas/canvas2d/base_rendering_context_2d.cc"
-#undef BRAVE_GET_IMAGE_DATA_PARAMS
-#undef BRAVE_GET_IMAGE_DATA
+#undef getImageData
 
 namespace {
 
@@ -40,6 +31,53 @@ bool AllowFingerprintingFromScriptState(blink::ScriptState* script_state) {
 
 namespace blink {
 
+ImageData* BaseRenderingContext2D::getImageData(
+    ScriptState* script_state,
+    int sx,
+    int sy,
+    int sw,
+    int sh,
+    ExceptionState& exception_state) {
+  ImageData* image_data =
+      getImageData_ChromiumImpl(sx, sy, sw, sh, exception_state);
+  if (!image_data)
+    return image_data;
+  NotShared<DOMUint8ClampedArray> data = image_data->data();
+  if (!data)
+    return image_data;
+  ExecutionContext* context = ExecutionContext::From(script_state);
+  if (!context)
+    return image_data;
+  WebContentSettingsClient* settings =
+      brave::GetContentSettingsClientFor(context);
+  brave::BraveSessionCache& cache = brave::BraveSessionCache::From(*context);
+  if (!cache.ShouldPerturbPixels(settings))
+    return image_data;
+  // The perturbation is derived from the whole canvas, as toDataURL() and
+  // toBlob() see it, so that the same pixels are perturbed whichever region
+  // is read back. Only the requested region is perturbed.
+  scoped_refptr<StaticBitmapImage> snapshot = GetImage();
+  if (!snapshot)
+    return image_data;
+  std::unique_ptr<ImageDataBuffer> canvas_buffer =
+      ImageDataBuffer::Create(snapshot);
+  if (!canvas_buffer)
+    return image_data;
+  // negative sizes read back the region to the left of or above the origin
+  if (sw < 0)
+    sx += sw;
+  if (sh < 0)
+    sy += sh;
+  cache.PerturbPixels(
+      settings,
+      base::make_span(canvas_buffer->Pixels(),
+                      canvas_buffer->ComputeByteSize()),
+      canvas_buffer->Width(), canvas_buffer->Height(),
+      base::make_span(data->Data(), data->lengthAsSizeT()),
+      IntRect(sx, sy, image_data->width(), image_data->height()));
+  return image_data;
+}
+
 ImageData* BaseRenderingContext2D::getImageDataUnused(
     int sx,
     int sy,
@@ -6,13 +6,15 @@
 #ifndef BRAVE_CHROMIUM_SRC_THIRD_PARTY_BLINK_RENDERER_MODULES_CANVAS_CANVAS2D_BASE_RENDERING_CONTEXT_2D_H_
 #define BRAVE_CHROMIUM_SRC_THIRD_PARTY_BLINK_RENDERER_MODULES_CANVAS_CANVAS2D_BASE_RENDERING_CONTEXT_2D_H_
 
-#define BRAVE_BASE_RENDERING_CONTEXT_2D_H                                   \
-  bool isPointInPath(ScriptState*, const double x, const double y,          \
-                     const String& winding = "nonzero");                    \
-  bool isPointInPath(ScriptState*, Path2D*, const double x, const double y, \
-                     const String& winding = "nonzero");                    \
-  bool isPointInStroke(ScriptState*, const double x, const double y);       \
-  bool isPointInStroke(ScriptState*, Path2D*, const double x, const double y);
+#define BRAVE_BASE_RENDERING_CONTEXT_2D_H                                      \
+  bool isPointInPath(ScriptState*, const double x, const double y,             \
+                     const String& winding = "nonzero");                       \
+  bool isPointInPath(ScriptState*, Path2D*, const double x, const double y,    \
+                     const String& winding = "nonzero");                       \
+  bool isPointInStroke(ScriptState*, const double x, const double y);          \
+  bool isPointInStroke(ScriptState*, Path2D*, const double x, const double y); \
+  ImageData* getImageData_ChromiumImpl(int sx, int sy, int sw, int sh,         \
+                                       ExceptionState&);
 
 #define getImageData                                                           \
   getImageData(ScriptState*, int sx, int sy, int sw, int sh, ExceptionState&); \
@@ -3,24 +3,27 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this file,
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
-#define BRAVE_REALTIMEANALYSER_CONVERTFLOATTODB                       \
-  if (audio_farbling_callback_) {                                     \
-    destination[i] = audio_farbling_callback_.Run(destination[i], i); \
+#define BRAVE_REALTIMEANALYSER_CONVERTFLOATTODB                           \
+  if (!audio_farbler_.IsIdentity()) {                                     \
+    destination[i] = audio_farbler_.FarbleSample(destination[i], i,       \
+                                                 &audio_farbling_state_); \
   }
 
-#define BRAVE_REALTIMEANALYSER_CONVERTTOBYTEDATA                  \
-  if (audio_farbling_callback_) {                                 \
-    scaled_value = audio_farbling_callback_.Run(scaled_value, i); \
+#define BRAVE_REALTIMEANALYSER_CONVERTTOBYTEDATA                              \
+  if (!audio_farbler_.IsIdentity()) {                                         \
+    scaled_value =                                                            \
+        audio_farbler_.FarbleSample(scaled_value, i, &audio_farbling_state_); \
   }
 
-#define BRAVE_REALTIMEANALYSER_GETFLOATTIMEDOMAINDATA        \
-  if (audio_farbling_callback_) {                            \
-    destination[i] = audio_farbling_callback_.Run(value, i); \
+#define BRAVE_REALTIMEANALYSER_GETFLOATTIMEDOMAINDATA                  \
+  if (!audio_farbler_.IsIdentity()) {                                  \
+    destination[i] =                                                   \
+        audio_farbler_.FarbleSample(value, i, &audio_farbling_state_); \
   }
 
-#define BRAVE_REALTIMEANALYSER_GETBYTETIMEDOMAINDATA \
-  if (audio_farbling_callback_) {                    \
-    value = audio_farbling_callback_.Run(value, i);  \
+#define BRAVE_REALTIMEANALYSER_GETBYTETIMEDOMAINDATA                       \
+  if (!audio_farbler_.IsIdentity()) {                                      \
+    value = audio_farbler_.FarbleSample(value, i, &audio_farbling_state_); \
   }
 
 #include "../../../../../../../third_party/blink/renderer/modules/webaudio/realtime_analyser.cc"
@@ -7,11 +7,13 @@
 
 #include <limits>
 #include <utility>
+#include <vector>
 
 #include "base/base64.h"
 #include "base/bind.h"
 #include "base/command_line.h"
 #include "base/containers/flat_map.h"
+#include "base/files/file.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/json/json_reader.h"
@@ -21,6 +23,7 @@
 #include "base/guid.h"
 #include "base/logging.h"
 #include "base/memory/ptr_util.h"
+#include "base/metrics/histogram_functions.h"
 #include "base/numerics/ranges.h"
 #include "base/sequenced_task_runner.h"
 #include "base/strings/string_number_conversions.h"
@@ -75,7 +78,6 @@
 #include "content/public/browser/network_service_instance.h"
 #include "content/public/browser/service_process_host.h"
 #include "content/public/browser/storage_partition.h"
-#include "net/base/network_change_notifier.h"
 #include "services/network/public/cpp/shared_url_loader_factory.h"
 #include "services/network/public/cpp/simple_url_loader.h"
 #include "third_party/dom_distiller_js/dom_distiller.pb.h"
@@ -157,6 +159,32 @@ std::string LoadOnFileTaskRunner(
   return data;
 }
 
+// Binary user models are converted and validated by the ads utility process,
+// and stored next to the JSON user model once per user model and binary format
+// version
+base::FilePath GetUserModelFilePath(
+    const base::FilePath& path) {
+  return path.AddExtensionASCII(ads::GetBinaryUserModelFileExtension());
+}
+
+base::File LoadUserModelJsonFileOnFileTaskRunner(
+    const base::FilePath& path) {
+  return base::File(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+}
+
+base::File LoadUserModelFileOnFileTaskRunner(
+    const base::FilePath& path) {
+  return base::File(GetUserModelFilePath(path),
+      base::File::FLAG_OPEN | base::File::FLAG_READ);
+}
+
+bool SaveUserModelFileOnFileTaskRunner(
+    const base::FilePath& path,
+    const std::string& value) {
+  return base::ImportantFileWriter::WriteFileAtomically(
+      GetUserModelFilePath(path), value);
+}
+
 bool EnsureBaseDirectoryExistsOnFileTaskRunner(
     const base::FilePath& path) {
   if (base::DirectoryExists(path)) {
@@ -214,6 +242,7 @@ AdsServiceImpl::AdsServiceImpl(Profile* profile) :
             base::TaskShutdownBehavior::BLOCK_SHUTDOWN})),
     base_path_(profile_->GetPath().AppendASCII("ads_service")),
     last_idle_state_(ui::IdleState::IDLE_STATE_ACTIVE),
+    connection_type_(network::mojom::ConnectionType::CONNECTION_UNKNOWN),
     display_service_(NotificationDisplayService::GetForProfile(profile_)),
     rewards_service_(brave_rewards::RewardsServiceFactory::GetForProfile(
         profile_)),
@@ -322,6 +351,10 @@ void AdsServiceImpl::OnPageLoaded(
     return;
   }
 
+  // Notification permission has no change notifications, so it is checked
+  // before each page load which may serve an ad
+  MaybeUpdateAdsClientState();
+
   bat_ads_->OnPageLoaded(tab_id.id(), original_url.spec(), url.spec(), content);
 }
 
@@ -538,6 +571,12 @@ void AdsServiceImpl::Shutdown() {
 
   g_brave_browser_process->user_model_file_service()->RemoveObserver(this);
 
+  if (is_observing_network_connection_) {
+    content::GetNetworkConnectionTracker()->RemoveNetworkConnectionObserver(
+        this);
+    is_observing_network_connection_ = false;
+  }
+
   for (auto* const url_loader : url_loaders_) {
     delete url_loader;
   }
@@ -631,9 +670,31 @@ void AdsServiceImpl::Initialize() {
   profile_pref_change_registrar_.Add(ads::prefs::kIdleThreshold,
       base::Bind(&AdsServiceImpl::OnPrefsChanged, base::Unretained(this)));
 
+  // Remaining ads prefs are only observed to keep the ads client state in sync
+  const std::vector<std::string> ads_client_state_prefs = {
+    ads::prefs::kShouldAllowConversionTracking,
+    ads::prefs::kAdsPerHour,
+    ads::prefs::kAdsPerDay,
+    ads::prefs::kShouldAllowAdsSubdivisionTargeting,
+    ads::prefs::kAdsSubdivisionTargetingCode,
+    ads::prefs::kAutoDetectedAdsSubdivisionTargetingCode
+  };
+
+  for (const auto& pref : ads_client_state_prefs) {
+    profile_pref_change_registrar_.Add(pref, base::Bind(
+        &AdsServiceImpl::OnPrefsChanged, base::Unretained(this)));
+  }
+
   profile_pref_change_registrar_.Add(brave_rewards::prefs::kWalletBrave,
       base::Bind(&AdsServiceImpl::OnPrefsChanged, base::Unretained(this)));
 
+  network::NetworkConnectionTracker* network_connection_tracker =
+      content::GetNetworkConnectionTracker();
+  network_connection_tracker->AddNetworkConnectionObserver(this);
+  is_observing_network_connection_ = true;
+  network_connection_tracker->GetConnectionType(&connection_type_,
+      base::BindOnce(&AdsServiceImpl::OnConnectionChanged, AsWeakPtr()));
+
   MaybeStart(false);
 }
 
@@ -828,6 +889,11 @@ void AdsServiceImpl::OnEnsureBaseDirectoryExists(
       bat_ads_.BindNewEndpointAndPassReceiver(),
       base::BindOnce(&AdsServiceImpl::OnCreate, AsWeakPtr()));
 
+  // Ads are initialized from |OnCreate|, so the first snapshot arrives before
+  // they read any state
+  last_ads_client_state_.reset();
+  MaybeUpdateAdsClientState();
+
   OnWalletUpdated();
 
   const std::string locale = GetLocale();
@@ -887,6 +953,53 @@ bool AdsServiceImpl::IsDebug() const {
   #endif
 }
 
+ads::AdsClientStatePtr AdsServiceImpl::BuildAdsClientState() const {
+  ads::AdsClientStatePtr state = ads::AdsClientState::New();
+
+  state->is_network_connection_available = IsNetworkConnectionAvailable();
+  state->is_foreground = IsForeground();
+  state->should_show_notifications =
+      NotificationHelper::GetInstance()->ShouldShowNotifications();
+  state->can_show_background_notifications = CanShowBackgroundNotifications();
+
+  state->boolean_prefs[ads::prefs::kEnabled] =
+      GetBooleanPref(ads::prefs::kEnabled);
+  state->boolean_prefs[ads::prefs::kShouldAllowConversionTracking] =
+      GetBooleanPref(ads::prefs::kShouldAllowConversionTracking);
+  state->boolean_prefs[ads::prefs::kShouldAllowAdsSubdivisionTargeting] =
+      GetBooleanPref(ads::prefs::kShouldAllowAdsSubdivisionTargeting);
+
+  state->integer_prefs[ads::prefs::kIdleThreshold] =
+      GetIntegerPref(ads::prefs::kIdleThreshold);
+
+  state->uint64_prefs[ads::prefs::kAdsPerHour] =
+      GetUint64Pref(ads::prefs::kAdsPerHour);
+  state->uint64_prefs[ads::prefs::kAdsPerDay] =
+      GetUint64Pref(ads::prefs::kAdsPerDay);
+
+  state->string_prefs[ads::prefs::kAdsSubdivisionTargetingCode] =
+      GetStringPref(ads::prefs::kAdsSubdivisionTargetingCode);
+  state->string_prefs[ads::prefs::kAutoDetectedAdsSubdivisionTargetingCode] =
+      GetStringPref(ads::prefs::kAutoDetectedAdsSubdivisionTargetingCode);
+
+  return state;
+}
+
+void AdsServiceImpl::MaybeUpdateAdsClientState() {
+  if (!connected()) {
+    return;
+  }
+
+  ads::AdsClientStatePtr state = BuildAdsClientState();
+  if (last_ads_client_state_ && last_ads_client_state_->Equals(*state)) {
+    return;
+  }
+
+  last_ads_client_state_ = state.Clone();
+
+  bat_ads_->OnAdsClientStateChanged(std::move(state));
+}
+
 void AdsServiceImpl::StartCheckIdleStateTimer() {
 #if !defined(OS_ANDROID)
   idle_poll_timer_.Stop();
@@ -897,6 +1010,10 @@ void AdsServiceImpl::StartCheckIdleStateTimer() {
 }
 
 void AdsServiceImpl::CheckIdleState() {
+  // Notification permission has no change notifications, so it is also picked
+  // up while polling
+  MaybeUpdateAdsClientState();
+
   auto idle_state = ui::CalculateIdleState(GetIdleThreshold());
   ProcessIdleState(idle_state);
 }
@@ -1280,6 +1397,19 @@ void AdsServiceImpl::OnLoaded(
     callback(ads::Result::SUCCESS, value);
 }
 
+void AdsServiceImpl::OnLoadUserModelFile(
+    const ads::LoadFileCallback& callback,
+    base::File file) {
+  if (!connected()) {
+    return;
+  }
+
+  if (!file.IsValid())
+    callback(ads::Result::FAILED, std::move(file));
+  else
+    callback(ads::Result::SUCCESS, std::move(file));
+}
+
 void AdsServiceImpl::OnSaved(
     const ads::ResultCallback& callback,
     const bool success) {
@@ -1644,6 +1774,8 @@ bool AdsServiceImpl::PrefExists(
 
 void AdsServiceImpl::OnPrefsChanged(
     const std::string& pref) {
+  MaybeUpdateAdsClientState();
+
   if (pref == ads::prefs::kEnabled) {
     rewards_service_->OnAdsEnabled(IsEnabled());
 
@@ -1686,7 +1818,7 @@ bool AdsServiceImpl::connected() {
 ///////////////////////////////////////////////////////////////////////////////
 
 bool AdsServiceImpl::IsNetworkConnectionAvailable() const {
-  return !net::NetworkChangeNotifier::IsOffline();
+  return connection_type_ != network::mojom::ConnectionType::CONNECTION_NONE;
 }
 
 bool AdsServiceImpl::IsForeground() const {
@@ -1848,6 +1980,64 @@ void AdsServiceImpl::LoadUserModelForId(
           std::move(callback)));
 }
 
+void AdsServiceImpl::LoadUserModelJsonFileForId(
+    const std::string& id,
+    ads::LoadFileCallback callback) {
+  const base::Optional<base::FilePath> path =
+      g_brave_browser_process->user_model_file_service()->GetPathForId(id);
+
+  if (!path) {
+    callback(ads::Result::FAILED, base::File());
+    return;
+  }
+
+  VLOG(1) << "Loading user model file " << path.value();
+
+  base::PostTaskAndReplyWithResult(file_task_runner_.get(), FROM_HERE,
+      base::BindOnce(&LoadUserModelJsonFileOnFileTaskRunner, path.value()),
+      base::BindOnce(&AdsServiceImpl::OnLoadUserModelFile, AsWeakPtr(),
+          std::move(callback)));
+}
+
+void AdsServiceImpl::LoadUserModelFileForId(
+    const std::string& id,
+    ads::LoadFileCallback callback) {
+  const base::Optional<base::FilePath> path =
+      g_brave_browser_process->user_model_file_service()->GetPathForId(id);
+
+  if (!path) {
+    callback(ads::Result::FAILED, base::File());
+    return;
+  }
+
+  VLOG(1) << "Loading user model file for " << path.value();
+
+  base::PostTaskAndReplyWithResult(file_task_runner_.get(), FROM_HERE,
+      base::BindOnce(&LoadUserModelFileOnFileTaskRunner, path.value()),
+      base::BindOnce(&AdsServiceImpl::OnLoadUserModelFile, AsWeakPtr(),
+          std::move(callback)));
+}
+
+void AdsServiceImpl::SaveUserModelFileForId(
+    const std::string& id,
+    const std::string& value,
+    ads::ResultCallback callback) {
+  const base::Optional<base::FilePath> path =
+      g_brave_browser_process->user_model_file_service()->GetPathForId(id);
+
+  if (!path) {
+    callback(ads::Result::FAILED);
+    return;
+  }
+
+  VLOG(1) << "Saving user model file for " << path.value();
+
+  base::PostTaskAndReplyWithResult(file_task_runner_.get(), FROM_HERE,
+      base::BindOnce(&SaveUserModelFileOnFileTaskRunner, path.value(), value),
+      base::BindOnce(&AdsServiceImpl::OnSaved, AsWeakPtr(),
+          std::move(callback)));
+}
+
 void AdsServiceImpl::RecordP2AEvent(
     const std::string& name,
     const ads::P2AEventType type,
@@ -1873,6 +2063,11 @@ void AdsServiceImpl::RecordP2AEvent(
   }
 }
 
+void AdsServiceImpl::RecordSyncIPCsPerServingAttempt(
+    const int count) {
+  base::UmaHistogramCounts100("Brave.Ads.SyncIPCsPerServingAttempt", count);
+}
+
 void AdsServiceImpl::Load(
     const std::string& name,
     ads::LoadCallback callback) {
@@ -2075,6 +2270,8 @@ void AdsServiceImpl::OnBackground() {
     return;
   }
 
+  MaybeUpdateAdsClientState();
+
   bat_ads_->OnBackground();
 }
 
@@ -2083,7 +2280,18 @@ void AdsServiceImpl::OnForeground() {
     return;
   }
 
+  // Notification permission may have been changed in system settings while the
+  // browser was in the background
+  MaybeUpdateAdsClientState();
+
   bat_ads_->OnForeground();
 }
 
+void AdsServiceImpl::OnConnectionChanged(
+    const network::mojom::ConnectionType type) {
+  connection_type_ = type;
+
+  MaybeUpdateAdsClientState();
+}
+
 }  // namespace brave_ads
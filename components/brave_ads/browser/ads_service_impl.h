@@ -35,6 +35,8 @@
 #include "mojo/public/cpp/bindings/associated_receiver.h"
 #include "mojo/public/cpp/bindings/associated_remote.h"
 #include "mojo/public/cpp/bindings/remote.h"
+#include "services/network/public/cpp/network_connection_tracker.h"
+#include "services/network/public/mojom/network_change_manager.mojom.h"
 #include "services/network/public/mojom/url_response_head.mojom.h"
 #include "ui/base/idle/idle.h"
 
@@ -65,6 +67,8 @@ class AdsServiceImpl : public AdsService,
                        public history::HistoryServiceObserver,
                        BackgroundHelper::Observer,
                        public brave_user_model::Observer,
+                       network::NetworkConnectionTracker::
+                           NetworkConnectionObserver,
                        public base::SupportsWeakPtr<AdsServiceImpl> {
  public:
   // AdsService implementation
@@ -222,6 +226,9 @@ class AdsServiceImpl : public AdsService,
   void UpdateIsDebugFlag();
   bool IsDebug() const;
 
+  ads::AdsClientStatePtr BuildAdsClientState() const;
+  void MaybeUpdateAdsClientState();
+
   void StartCheckIdleStateTimer();
   void CheckIdleState();
   void ProcessIdleState(
@@ -307,6 +314,9 @@ class AdsServiceImpl : public AdsService,
   void OnLoaded(
       const ads::LoadCallback& callback,
       const std::string& value);
+  void OnLoadUserModelFile(
+      const ads::LoadFileCallback& callback,
+      base::File file);
   void OnSaved(
       const ads::ResultCallback& callback,
       const bool success);
@@ -385,11 +395,27 @@ class AdsServiceImpl : public AdsService,
       const std::string& id,
       ads::LoadCallback callback) override;
 
+  void LoadUserModelJsonFileForId(
+      const std::string& id,
+      ads::LoadFileCallback callback) override;
+
+  void LoadUserModelFileForId(
+      const std::string& id,
+      ads::LoadFileCallback callback) override;
+
+  void SaveUserModelFileForId(
+      const std::string& id,
+      const std::string& value,
+      ads::ResultCallback callback) override;
+
   void RecordP2AEvent(
       const std::string& name,
       const ads::P2AEventType type,
       const std::string& value) override;
 
+  void RecordSyncIPCsPerServingAttempt(
+      const int count) override;
+
   void Load(
       const std::string& name,
       ads::LoadCallback callback) override;
@@ -464,6 +490,10 @@ class AdsServiceImpl : public AdsService,
   void OnBackground() override;
   void OnForeground() override;
 
+  // NetworkConnectionTracker::NetworkConnectionObserver implementation
+  void OnConnectionChanged(
+      const network::mojom::ConnectionType type) override;
+
 ///////////////////////////////////////////////////////////////////////////////
 
   Profile* profile_;  // NOT OWNED
@@ -487,6 +517,12 @@ class AdsServiceImpl : public AdsService,
 
   ui::IdleState last_idle_state_;
 
+  ads::AdsClientStatePtr last_ads_client_state_;
+
+  network::mojom::ConnectionType connection_type_;
+  // The observer is only added once the service is initialized
+  bool is_observing_network_connection_ = false;
+
   base::RepeatingTimer idle_poll_timer_;
 
   PrefChangeRegistrar profile_pref_change_registrar_;
@@ -6,10 +6,13 @@
 #include "brave/components/brave_ads/browser/ads_tab_helper.h"
 
 #include <memory>
+#include <string>
 #include <utility>
 
+#include "base/strings/stringprintf.h"
 #include "brave/components/brave_ads/browser/ads_service.h"
 #include "brave/components/brave_ads/browser/ads_service_factory.h"
+#include "brave/vendor/bat-native-ads/include/bat/ads/public/interfaces/ads.mojom.h"
 #include "chrome/browser/profiles/profile.h"
 #include "components/dom_distiller/content/browser/distiller_page_web_contents.h"
 #include "components/dom_distiller/content/browser/distiller_javascript_utils.h"
@@ -27,6 +30,39 @@
 
 namespace brave_ads {
 
+namespace {
+
+// Very long pages are sampled from their head and tail in the renderer so that
+// the page content sent to the ads service is bounded. |innerText| is measured
+// in UTF-16 code units, each of which is at least one UTF-8 byte, so the sample
+// always covers the head and tail which the page classifier keeps. Samples are
+// not cut between the two halves of a surrogate pair
+const char kGetPageContentScript[] =
+    "(function() {"
+    "  const content = document.body.innerText;"
+    "  const max_length = %u;"
+    "  if (content.length <= max_length) {"
+    "    return content;"
+    "  }"
+    "  const isLowSurrogate = (index) => {"
+    "    const c = content.charCodeAt(index);"
+    "    return c >= 0xdc00 && c <= 0xdfff;"
+    "  };"
+    "  const sample_length = max_length / 2;"
+    "  let head_end = sample_length;"
+    "  if (isLowSurrogate(head_end)) {"
+    "    head_end--;"
+    "  }"
+    "  let tail_start = content.length - sample_length;"
+    "  if (isLowSurrogate(tail_start)) {"
+    "    tail_start++;"
+    "  }"
+    "  return content.slice(0, head_end) + '\\n' +"
+    "      content.slice(tail_start);"
+    "})()";
+
+}  // namespace
+
 AdsTabHelper::AdsTabHelper(content::WebContents* web_contents)
     : WebContentsObserver(web_contents),
       tab_id_(sessions::SessionTabHelper::IdForTab(web_contents)),
@@ -77,8 +113,10 @@ void AdsTabHelper::RunIsolatedJavaScript(
     content::RenderFrameHost* render_frame_host) {
   DCHECK(render_frame_host);
 
-  dom_distiller::RunIsolatedJavaScript(render_frame_host,
-      "document.body.innerText",
+  const std::string script = base::StringPrintf(kGetPageContentScript,
+      ads::mojom::kMaximumPageContentLength);
+
+  dom_distiller::RunIsolatedJavaScript(render_frame_host, script,
           base::BindOnce(&AdsTabHelper::OnJavaScriptResult,
               weak_factory_.GetWeakPtr()));
 }
@@ -177,6 +177,21 @@ std::string LoadOnFileTaskRunner(const base::FilePath& path) {
   return data;
 }
 
+base::File OpenPublisherPrefixListOnFileTaskRunner(
+    const base::FilePath& path) {
+  return base::File(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+}
+
+base::File SavePublisherPrefixListOnFileTaskRunner(
+    const base::FilePath& path,
+    const std::string& contents) {
+  if (!base::ImportantFileWriter::WriteFileAtomically(path, contents)) {
+    return base::File();
+  }
+
+  return OpenPublisherPrefixListOnFileTaskRunner(path);
+}
+
 net::NetworkTrafficAnnotationTag
 GetNetworkTrafficAnnotationTagForFaviconFetch() {
   return net::DefineNetworkTrafficAnnotation(
@@ -285,12 +300,16 @@ const base::FilePath::StringType kLedger_state(L"ledger_state");
 const base::FilePath::StringType kPublisher_state(L"publisher_state");
 const base::FilePath::StringType kPublisher_info_db(L"publisher_info_db");
 const base::FilePath::StringType kPublishers_list(L"publishers_list");
+const base::FilePath::StringType kPublisher_prefix_list(
+    L"publisher_prefix_list.bin");
 #else
 const base::FilePath::StringType kDiagnosticLogPath("Rewards.log");
 const base::FilePath::StringType kLedger_state("ledger_state");
 const base::FilePath::StringType kPublisher_state("publisher_state");
 const base::FilePath::StringType kPublisher_info_db("publisher_info_db");
 const base::FilePath::StringType kPublishers_list("publishers_list");
+const base::FilePath::StringType kPublisher_prefix_list(
+    "publisher_prefix_list.bin");
 #endif
 
 #if BUILDFLAG(ENABLE_GREASELION)
@@ -314,6 +333,8 @@ RewardsServiceImpl::RewardsServiceImpl(Profile* profile)
       publisher_state_path_(profile_->GetPath().Append(kPublisher_state)),
       publisher_info_db_path_(profile->GetPath().Append(kPublisher_info_db)),
       publisher_list_path_(profile->GetPath().Append(kPublishers_list)),
+      publisher_prefix_list_path_(
+          profile->GetPath().Append(kPublisher_prefix_list)),
       notification_service_(new RewardsNotificationServiceImpl(profile)),
       next_timer_id_(0) {
   // Set up the rewards data source
@@ -467,6 +488,14 @@ void RewardsServiceImpl::StartLedger(StartProcessCallback callback) {
     }
   }
 
+  // The ledger process drops messages that would neither be written to the
+  // diagnostic log nor to the console before formatting them
+  const int log_verbose_level = should_persist_logs_
+      ? kDiagnosticLogMaxVerboseLevel
+      : 0;
+  bat_ledger_service_->SetLogVerboseLevel(
+      std::max(log_verbose_level, ::logging::GetVlogVerbosity()));
+
   bat_ledger_service_->Create(
       bat_ledger_client_receiver_.BindNewEndpointAndPassRemote(),
       bat_ledger_.BindNewEndpointAndPassReceiver(),
@@ -1392,6 +1421,7 @@ bool RewardsServiceImpl::ResetOnFilesTaskRunner() {
     publisher_info_db_path_,
     diagnostic_log_path_,
     publisher_list_path_,
+    publisher_prefix_list_path_,
   };
 
   bool res = true;
@@ -2191,6 +2221,15 @@ void RewardsServiceImpl::DiagnosticLog(
     const int line,
     const int verbose_level,
     const std::string& message) {
+  AddDiagnosticLogEntry(base::Time::Now(), file, line, verbose_level, message);
+}
+
+void RewardsServiceImpl::AddDiagnosticLogEntry(
+    const base::Time created_at,
+    const std::string& file,
+    const int line,
+    const int verbose_level,
+    const std::string& message) {
   if (ledger_for_testing_ || !should_persist_logs_) {
     return;
   }
@@ -2203,26 +2242,42 @@ void RewardsServiceImpl::DiagnosticLog(
     return;
   }
 
+  pending_diagnostic_log_entries_ += FriendlyFormatLogEntry(
+      created_at, file, line, verbose_level, message);
+
+  MaybeWriteDiagnosticLog();
+}
+
+void RewardsServiceImpl::MaybeWriteDiagnosticLog() {
+  // Entries logged while a write is in flight are written together once it
+  // completes
+  if (is_writing_diagnostic_log_ || pending_diagnostic_log_entries_.empty()) {
+    return;
+  }
+
+  if (resetting_rewards_) {
+    pending_diagnostic_log_entries_.clear();
+    return;
+  }
+
+  is_writing_diagnostic_log_ = true;
+
   base::PostTaskAndReplyWithResult(file_task_runner_.get(), FROM_HERE,
       base::BindOnce(&RewardsServiceImpl::WriteToDiagnosticLogOnFileTaskRunner,
           base::Unretained(this),
           diagnostic_log_path_,
           kTailDiagnosticLogToNumLines,
-          file,
-          line,
-          verbose_level,
-          message),
+          std::move(pending_diagnostic_log_entries_)),
       base::BindOnce(&RewardsServiceImpl::OnWriteToLogOnFileTaskRunner,
           AsWeakPtr()));
+
+  pending_diagnostic_log_entries_.clear();
 }
 
 bool RewardsServiceImpl::WriteToDiagnosticLogOnFileTaskRunner(
     const base::FilePath& log_path,
     const int num_lines,
-    const std::string& file,
-    const int line,
-    const int verbose_level,
-    const std::string& message) {
+    const std::string& log_entries) {
   if (!InitializeLog(&diagnostic_log_, log_path)) {
     VLOG(0) << "Failed to initialize diagnostic log: "
         << GetLastFileError(&diagnostic_log_);
@@ -2230,12 +2285,7 @@ bool RewardsServiceImpl::WriteToDiagnosticLogOnFileTaskRunner(
     return false;
   }
 
-  const base::Time time = base::Time::Now();
-
-  const std::string log_entry =
-      FriendlyFormatLogEntry(time, file, line, verbose_level, message);
-
-  if (!WriteToLog(&diagnostic_log_, log_entry)) {
+  if (!WriteToLog(&diagnostic_log_, log_entries)) {
     VLOG(0) << "Failed to write to diagnostic log: "
         << GetLastFileError(&diagnostic_log_);
 
@@ -2254,6 +2304,10 @@ bool RewardsServiceImpl::WriteToDiagnosticLogOnFileTaskRunner(
 void RewardsServiceImpl::OnWriteToLogOnFileTaskRunner(
     const bool success) {
   DCHECK(success);
+
+  is_writing_diagnostic_log_ = false;
+
+  MaybeWriteDiagnosticLog();
 }
 
 void RewardsServiceImpl::LoadDiagnosticLog(
@@ -2324,9 +2378,18 @@ void RewardsServiceImpl::Log(
     const int line,
     const int verbose_level,
     const std::string& message) {
+  LogWithTime(base::Time::Now(), file, line, verbose_level, message);
+}
+
+void RewardsServiceImpl::LogWithTime(
+    const base::Time created_at,
+    const char* file,
+    const int line,
+    const int verbose_level,
+    const std::string& message) {
   DCHECK(file);
 
-  DiagnosticLog(file, line, verbose_level, message);
+  AddDiagnosticLogEntry(created_at, file, line, verbose_level, message);
 
   const int vlog_level = ::logging::GetVlogLevelHelper(file, strlen(file));
   if (verbose_level <= vlog_level) {
@@ -3320,6 +3383,47 @@ void RewardsServiceImpl::OnDeleteLog(
   callback(result);
 }
 
+void RewardsServiceImpl::SavePublisherPrefixList(
+    const std::string& contents,
+    ledger::client::LoadFileCallback callback) {
+  base::PostTaskAndReplyWithResult(
+      file_task_runner_.get(),
+      FROM_HERE,
+      base::BindOnce(
+          &SavePublisherPrefixListOnFileTaskRunner,
+          publisher_prefix_list_path_,
+          contents),
+      base::BindOnce(
+          &RewardsServiceImpl::OnLoadPublisherPrefixList,
+          AsWeakPtr(),
+          std::move(callback)));
+}
+
+void RewardsServiceImpl::LoadPublisherPrefixList(
+    ledger::client::LoadFileCallback callback) {
+  base::PostTaskAndReplyWithResult(
+      file_task_runner_.get(),
+      FROM_HERE,
+      base::BindOnce(
+          &OpenPublisherPrefixListOnFileTaskRunner,
+          publisher_prefix_list_path_),
+      base::BindOnce(
+          &RewardsServiceImpl::OnLoadPublisherPrefixList,
+          AsWeakPtr(),
+          std::move(callback)));
+}
+
+void RewardsServiceImpl::OnLoadPublisherPrefixList(
+    ledger::client::LoadFileCallback callback,
+    base::File file) {
+  if (!file.IsValid()) {
+    callback(ledger::type::Result::LEDGER_ERROR, base::File());
+    return;
+  }
+
+  callback(ledger::type::Result::LEDGER_OK, std::move(file));
+}
+
 void RewardsServiceImpl::GetEventLogs(GetEventLogsCallback callback) {
   if (!Connected()) {
     return;
@@ -346,6 +346,7 @@ class RewardsServiceImpl : public RewardsService,
 
  private:
   friend class ::RewardsFlagBrowserTest;
+  friend class RewardsServiceTest;
 
   void OnConnectionClosed(const ledger::type::Result result);
 
@@ -564,14 +565,20 @@ class RewardsServiceImpl : public RewardsService,
       const int verbose_level,
       const std::string& message) override;
 
-  bool WriteToDiagnosticLogOnFileTaskRunner(
-      const base::FilePath& log_path,
-      const int num_lines,
+  void AddDiagnosticLogEntry(
+      const base::Time created_at,
       const std::string& file,
       const int line,
       const int verbose_level,
       const std::string& message);
 
+  void MaybeWriteDiagnosticLog();
+
+  bool WriteToDiagnosticLogOnFileTaskRunner(
+      const base::FilePath& log_path,
+      const int num_lines,
+      const std::string& log_entries);
+
   void OnWriteToLogOnFileTaskRunner(
     const bool success);
 
@@ -604,6 +611,13 @@ class RewardsServiceImpl : public RewardsService,
       const int verbose_level,
       const std::string& message) override;
 
+  void LogWithTime(
+      const base::Time created_at,
+      const char* file,
+      const int line,
+      const int verbose_level,
+      const std::string& message) override;
+
   void SetBooleanState(const std::string& name, bool value) override;
   bool GetBooleanState(const std::string& name) const override;
   void SetIntegerState(const std::string& name, int value) override;
@@ -660,6 +674,13 @@ class RewardsServiceImpl : public RewardsService,
 
   void DeleteLog(ledger::ResultCallback callback) override;
 
+  void SavePublisherPrefixList(
+      const std::string& contents,
+      ledger::client::LoadFileCallback callback) override;
+
+  void LoadPublisherPrefixList(
+      ledger::client::LoadFileCallback callback) override;
+
   // end ledger::LedgerClient
 
   // Mojo Proxy methods
@@ -736,6 +757,10 @@ class RewardsServiceImpl : public RewardsService,
 
   void OnDeleteLog(ledger::ResultCallback callback, const bool success);
 
+  void OnLoadPublisherPrefixList(
+      ledger::client::LoadFileCallback callback,
+      base::File file);
+
   void OnGetEventLogs(
       GetEventLogsCallback callback,
       ledger::type::EventLogs logs);
@@ -767,6 +792,7 @@ class RewardsServiceImpl : public RewardsService,
   const base::FilePath publisher_state_path_;
   const base::FilePath publisher_info_db_path_;
   const base::FilePath publisher_list_path_;
+  const base::FilePath publisher_prefix_list_path_;
   std::unique_ptr<ledger::LedgerDatabase> ledger_database_;
   std::unique_ptr<RewardsNotificationServiceImpl> notification_service_;
   base::ObserverList<RewardsServicePrivateObserver> private_observers_;
@@ -787,6 +813,8 @@ class RewardsServiceImpl : public RewardsService,
   bool ledger_for_testing_ = false;
   bool resetting_rewards_ = false;
   bool should_persist_logs_ = false;
+  std::string pending_diagnostic_log_entries_;
+  bool is_writing_diagnostic_log_ = false;
 
   GetTestResponseCallback test_response_callback_;
 
@@ -4,10 +4,14 @@
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include <map>
+#include <string>
 
+#include "base/files/file_util.h"
 #include "base/files/scoped_temp_dir.h"
+#include "base/time/time.h"
 #include "bat/ledger/mojom_structs.h"
 #include "brave/browser/brave_rewards/rewards_service_factory.h"
+#include "brave/components/brave_rewards/browser/logging_util.h"
 #include "brave/components/brave_rewards/browser/rewards_service_impl.h"
 #include "brave/components/brave_rewards/browser/rewards_service_observer.h"
 #include "brave/components/brave_rewards/browser/test_util.h"
@@ -76,6 +80,33 @@ class RewardsServiceTest : public testing::Test {
   RewardsServiceImpl* rewards_service() { return rewards_service_; }
   MockRewardsServiceObserver* observer() { return observer_.get(); }
 
+  void EnablePersistLogs() {
+    rewards_service_->should_persist_logs_ = true;
+  }
+
+  void LogWithTime(
+      const base::Time created_at,
+      const std::string& message) {
+    rewards_service_->LogWithTime(created_at, "rewards_service_impl.cc", 1,
+        1, message);
+  }
+
+  bool IsWritingDiagnosticLog() const {
+    return rewards_service_->is_writing_diagnostic_log_;
+  }
+
+  const std::string& GetPendingDiagnosticLogEntries() const {
+    return rewards_service_->pending_diagnostic_log_entries_;
+  }
+
+  std::string ReadDiagnosticLog() const {
+    std::string contents;
+    base::ReadFileToString(rewards_service_->diagnostic_log_path_, &contents);
+    return contents;
+  }
+
+  void RunUntilIdle() { task_environment_.RunUntilIdle(); }
+
  private:
   // Need this as a very first member to run tests in UI thread
   // When this is set, class should not install any other MessageLoops, like
@@ -87,6 +118,43 @@ class RewardsServiceTest : public testing::Test {
   base::ScopedTempDir temp_dir_;
 };
 
+TEST_F(RewardsServiceTest, WriteDiagnosticLogEntriesLoggedDuringWrite) {
+  EnablePersistLogs();
+  const base::Time now = base::Time::Now();
+
+  LogWithTime(now, "first");
+  LogWithTime(now, "second");
+  LogWithTime(now, "third");
+
+  // Only the first entry is being written, the others are written together
+  // once it completes
+  EXPECT_TRUE(IsWritingDiagnosticLog());
+  EXPECT_EQ(GetPendingDiagnosticLogEntries(),
+      FriendlyFormatLogEntry(now, "rewards_service_impl.cc", 1, 1, "second") +
+      FriendlyFormatLogEntry(now, "rewards_service_impl.cc", 1, 1, "third"));
+
+  RunUntilIdle();
+
+  EXPECT_FALSE(IsWritingDiagnosticLog());
+  EXPECT_TRUE(GetPendingDiagnosticLogEntries().empty());
+  EXPECT_EQ(ReadDiagnosticLog(),
+      FriendlyFormatLogEntry(now, "rewards_service_impl.cc", 1, 1, "first") +
+      FriendlyFormatLogEntry(now, "rewards_service_impl.cc", 1, 1, "second") +
+      FriendlyFormatLogEntry(now, "rewards_service_impl.cc", 1, 1, "third"));
+}
+
+TEST_F(RewardsServiceTest, FormatDiagnosticLogEntryWithCreationTime) {
+  EnablePersistLogs();
+  const base::Time created_at =
+      base::Time::Now() - base::TimeDelta::FromSeconds(5);
+
+  LogWithTime(created_at, "message");
+  RunUntilIdle();
+
+  EXPECT_EQ(ReadDiagnosticLog(), FriendlyFormatLogEntry(created_at,
+      "rewards_service_impl.cc", 1, 1, "message"));
+}
+
 // add test for strange entries
 
 }  // namespace brave_rewards
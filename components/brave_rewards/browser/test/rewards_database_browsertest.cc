@@ -12,6 +12,7 @@
 #include "brave/browser/brave_rewards/rewards_service_factory.h"
 #include "brave/common/brave_paths.h"
 #include "brave/components/brave_rewards/browser/rewards_service_impl.h"
+#include "brave/components/brave_rewards/browser/test/common/rewards_browsertest_context_helper.h"
 #include "brave/components/brave_rewards/browser/test/common/rewards_browsertest_network_util.h"
 #include "brave/components/brave_rewards/browser/test/common/rewards_browsertest_response.h"
 #include "brave/components/brave_rewards/browser/test/common/rewards_browsertest_util.h"
@@ -19,6 +20,7 @@
 #include "chrome/common/chrome_paths.h"
 #include "chrome/test/base/in_process_browser_test.h"
 #include "chrome/test/base/testing_profile.h"
+#include "components/network_session_configurator/common/network_switches.h"
 #include "content/public/test/browser_test.h"
 #include "net/dns/mock_host_resolver.h"
 #include "sql/database.h"
@@ -45,7 +47,11 @@ class RewardsDatabaseBrowserTest : public InProcessBrowserTest {
   void SetUpOnMainThread() override {
     InProcessBrowserTest::SetUpOnMainThread();
 
+    context_helper_ =
+        std::make_unique<RewardsBrowserTestContextHelper>(browser());
+
     // HTTP resolver
+    host_resolver()->AddRule("*", "127.0.0.1");
     https_server_.reset(new net::EmbeddedTestServer(
         net::test_server::EmbeddedTestServer::TYPE_HTTPS));
     https_server_->SetSSLConfig(net::EmbeddedTestServer::CERT_OK);
@@ -69,6 +75,12 @@ class RewardsDatabaseBrowserTest : public InProcessBrowserTest {
     rewards_service_->SetLedgerEnvForTesting();
   }
 
+  void SetUpCommandLine(base::CommandLine* command_line) override {
+    // HTTPS server only serves a valid cert for localhost, so this is needed
+    // to load pages from other hosts without an error
+    command_line->AppendSwitch(switches::kIgnoreCertificateErrors);
+  }
+
   void GetTestResponse(
       const std::string& url,
       int32_t method,
@@ -240,6 +252,7 @@ class RewardsDatabaseBrowserTest : public InProcessBrowserTest {
   sql::MetaTable meta_table_;
   std::unique_ptr<net::EmbeddedTestServer> https_server_;
   std::unique_ptr<RewardsBrowserTestResponse> response_;
+  std::unique_ptr<RewardsBrowserTestContextHelper> context_helper_;
 };
 
 IN_PROC_BROWSER_TEST_F(RewardsDatabaseBrowserTest, SchemaCheck_2) {
@@ -895,4 +908,23 @@ IN_PROC_BROWSER_TEST_F(
   }
 }
 
+IN_PROC_BROWSER_TEST_F(
+    RewardsDatabaseBrowserTest,
+    Migration_30_PublisherPrefixListDropped) {
+  base::ScopedAllowBlockingForTesting allow_blocking;
+  InitDB();
+  EXPECT_FALSE(db_.DoesTableExist("publisher_prefix_list"));
+  EXPECT_EQ(
+      GetTableVersionNumber(),
+      ledger::database::GetCurrentVersion());
+
+  // Searches are served from the downloaded prefix list file now
+  rewards_browsertest_util::StartProcess(rewards_service_);
+  rewards_service_->SetAutoContributeEnabled(true);
+  context_helper_->LoadURL(rewards_browsertest_util::GetRewardsUrl());
+  context_helper_->VisitPublisher(
+      rewards_browsertest_util::GetUrl(https_server_.get(), "duckduckgo.com"),
+      true);
+}
+
 }  // namespace rewards_browsertest
@@ -161,6 +161,63 @@ void BatAdsClientMojoBridge::LoadUserModelForId(
       base::BindOnce(&OnLoadUserModelForId, std::move(callback)));
 }
 
+void OnLoadUserModelJsonFileForId(
+    const ads::LoadFileCallback& callback,
+    const int32_t result,
+    base::File file) {
+  callback(ToAdsResult(result), std::move(file));
+}
+
+void BatAdsClientMojoBridge::LoadUserModelJsonFileForId(
+    const std::string& id,
+    ads::LoadFileCallback callback) {
+  if (!connected()) {
+    callback(ads::Result::FAILED, base::File());
+    return;
+  }
+
+  bat_ads_client_->LoadUserModelJsonFileForId(id,
+      base::BindOnce(&OnLoadUserModelJsonFileForId, std::move(callback)));
+}
+
+void OnLoadUserModelFileForId(
+    const ads::LoadFileCallback& callback,
+    const int32_t result,
+    base::File file) {
+  callback(ToAdsResult(result), std::move(file));
+}
+
+void BatAdsClientMojoBridge::LoadUserModelFileForId(
+    const std::string& id,
+    ads::LoadFileCallback callback) {
+  if (!connected()) {
+    callback(ads::Result::FAILED, base::File());
+    return;
+  }
+
+  bat_ads_client_->LoadUserModelFileForId(id,
+      base::BindOnce(&OnLoadUserModelFileForId, std::move(callback)));
+}
+
+void OnSaveUserModelFileForId(
+    const ads::ResultCallback& callback,
+    const int32_t result) {
+  callback(ToAdsResult(result));
+}
+
+void BatAdsClientMojoBridge::SaveUserModelFileForId(
+    const std::string& id,
+    const std::string& value,
+    ads::ResultCallback callback) {
+  if (!connected()) {
+    callback(ads::Result::FAILED);
+    return;
+  }
+
+  bat_ads_client_->SaveUserModelFileForId(id, value,
+      base::BindOnce(&OnSaveUserModelFileForId, std::move(callback)));
+}
+
 void BatAdsClientMojoBridge::RecordP2AEvent(
     const std::string& name,
     const ads::P2AEventType type,
@@ -172,6 +229,15 @@ void BatAdsClientMojoBridge::RecordP2AEvent(
   bat_ads_client_->RecordP2AEvent(name, type, value);
 }
 
+void BatAdsClientMojoBridge::RecordSyncIPCsPerServingAttempt(
+    const int count) {
+  if (!connected()) {
+    return;
+  }
+
+  bat_ads_client_->RecordSyncIPCsPerServingAttempt(count);
+}
+
 void OnLoad(
     const ads::LoadCallback& callback,
     const int32_t result,
@@ -53,11 +53,27 @@ class BatAdsClientMojoBridge
       const std::string& id,
       ads::LoadCallback callback) override;
 
+  void LoadUserModelJsonFileForId(
+      const std::string& id,
+      ads::LoadFileCallback callback) override;
+
+  void LoadUserModelFileForId(
+      const std::string& id,
+      ads::LoadFileCallback callback) override;
+
+  void SaveUserModelFileForId(
+      const std::string& id,
+      const std::string& value,
+      ads::ResultCallback callback) override;
+
   void RecordP2AEvent(
       const std::string& name,
       const ads::P2AEventType type,
       const std::string& value) override;
 
+  void RecordSyncIPCsPerServingAttempt(
+      const int count) override;
+
   void Load(
       const std::string& name,
       ads::LoadCallback callback) override;
@@ -94,6 +94,11 @@ void BatAdsImpl::OnBackground() {
   ads_->OnBackground();
 }
 
+void BatAdsImpl::OnAdsClientStateChanged(
+    ads::AdsClientStatePtr state) {
+  ads_->OnAdsClientStateChanged(std::move(state));
+}
+
 void BatAdsImpl::OnMediaPlaying(
     const int32_t tab_id) {
   ads_->OnMediaPlaying(tab_id);
@@ -59,6 +59,9 @@ class BatAdsImpl :
   void OnForeground() override;
   void OnBackground() override;
 
+  void OnAdsClientStateChanged(
+      ads::AdsClientStatePtr state) override;
+
   void OnMediaPlaying(
       const int32_t tab_id) override;
   void OnMediaStopped(
@@ -123,6 +123,78 @@ void AdsClientMojoBridge::LoadUserModelForId(
       id, std::bind(AdsClientMojoBridge::OnLoadUserModelForId, holder, _1, _2));
 }
 
+// static
+void AdsClientMojoBridge::OnLoadUserModelJsonFileForId(
+    CallbackHolder<LoadUserModelJsonFileForIdCallback>* holder,
+    const ads::Result result,
+    base::File file) {
+  DCHECK(holder);
+
+  if (holder->is_valid()) {
+    std::move(holder->get()).Run((int32_t)result, std::move(file));
+  }
+
+  delete holder;
+}
+
+void AdsClientMojoBridge::LoadUserModelJsonFileForId(
+    const std::string& id,
+    LoadUserModelJsonFileForIdCallback callback) {
+  // this gets deleted in OnLoadUserModelJsonFileForId
+  auto* holder = new CallbackHolder<LoadUserModelJsonFileForIdCallback>(
+      AsWeakPtr(), std::move(callback));
+  ads_client_->LoadUserModelJsonFileForId(id, std::bind(
+      AdsClientMojoBridge::OnLoadUserModelJsonFileForId, holder, _1, _2));
+}
+
+// static
+void AdsClientMojoBridge::OnLoadUserModelFileForId(
+    CallbackHolder<LoadUserModelFileForIdCallback>* holder,
+    const ads::Result result,
+    base::File file) {
+  DCHECK(holder);
+
+  if (holder->is_valid()) {
+    std::move(holder->get()).Run((int32_t)result, std::move(file));
+  }
+
+  delete holder;
+}
+
+void AdsClientMojoBridge::LoadUserModelFileForId(
+    const std::string& id,
+    LoadUserModelFileForIdCallback callback) {
+  // this gets deleted in OnLoadUserModelFileForId
+  auto* holder = new CallbackHolder<LoadUserModelFileForIdCallback>(
+      AsWeakPtr(), std::move(callback));
+  ads_client_->LoadUserModelFileForId(id, std::bind(
+      AdsClientMojoBridge::OnLoadUserModelFileForId, holder, _1, _2));
+}
+
+// static
+void AdsClientMojoBridge::OnSaveUserModelFileForId(
+    CallbackHolder<SaveUserModelFileForIdCallback>* holder,
+    const ads::Result result) {
+  DCHECK(holder);
+
+  if (holder->is_valid()) {
+    std::move(holder->get()).Run((int32_t)result);
+  }
+
+  delete holder;
+}
+
+void AdsClientMojoBridge::SaveUserModelFileForId(
+    const std::string& id,
+    const std::string& value,
+    SaveUserModelFileForIdCallback callback) {
+  // this gets deleted in OnSaveUserModelFileForId
+  auto* holder = new CallbackHolder<SaveUserModelFileForIdCallback>(
+      AsWeakPtr(), std::move(callback));
+  ads_client_->SaveUserModelFileForId(id, value, std::bind(
+      AdsClientMojoBridge::OnSaveUserModelFileForId, holder, _1));
+}
+
 void AdsClientMojoBridge::RecordP2AEvent(
     const std::string& name,
     const ads::P2AEventType type,
@@ -130,6 +202,11 @@ void AdsClientMojoBridge::RecordP2AEvent(
   ads_client_->RecordP2AEvent(name, type, out_value);
 }
 
+void AdsClientMojoBridge::RecordSyncIPCsPerServingAttempt(
+    const int32_t count) {
+  ads_client_->RecordSyncIPCsPerServingAttempt(count);
+}
+
 // static
 void AdsClientMojoBridge::OnLoad(
     CallbackHolder<LoadCallback>* holder,
@@ -62,11 +62,27 @@ class AdsClientMojoBridge
       const std::string& id,
       LoadCallback callback) override;
 
+  void LoadUserModelJsonFileForId(
+      const std::string& id,
+      LoadUserModelJsonFileForIdCallback callback) override;
+
+  void LoadUserModelFileForId(
+      const std::string& id,
+      LoadUserModelFileForIdCallback callback) override;
+
+  void SaveUserModelFileForId(
+      const std::string& id,
+      const std::string& value,
+      SaveUserModelFileForIdCallback callback) override;
+
   void RecordP2AEvent(
       const std::string& name,
       const ads::P2AEventType type,
       const std::string& out_value) override;
 
+  void RecordSyncIPCsPerServingAttempt(
+      const int32_t count) override;
+
   void Load(
       const std::string& name,
       LoadCallback callback) override;
@@ -156,6 +172,20 @@ class AdsClientMojoBridge
       const ads::Result result,
       const std::string& value);
 
+  static void OnLoadUserModelJsonFileForId(
+      CallbackHolder<LoadUserModelJsonFileForIdCallback>* holder,
+      const ads::Result result,
+      base::File file);
+
+  static void OnLoadUserModelFileForId(
+      CallbackHolder<LoadUserModelFileForIdCallback>* holder,
+      const ads::Result result,
+      base::File file);
+
+  static void OnSaveUserModelFileForId(
+      CallbackHolder<SaveUserModelFileForIdCallback>* holder,
+      const ads::Result result);
+
   static void OnLoad(
       CallbackHolder<LoadCallback>* holder,
       const ads::Result result,
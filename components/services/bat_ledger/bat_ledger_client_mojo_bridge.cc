@@ -11,16 +11,27 @@
 #include <vector>
 
 #include "base/logging.h"
+#include "base/time/time.h"
 #include "brave/base/containers/utils.h"
 
 namespace bat_ledger {
 
+namespace {
+
+const size_t kMaxBufferedLogRecords = 100;
+
+const int64_t kFlushLogRecordsDelayInMilliseconds = 500;
+
+}  // namespace
+
 BatLedgerClientMojoBridge::BatLedgerClientMojoBridge(
       mojo::PendingAssociatedRemote<mojom::BatLedgerClient> client_info) {
   bat_ledger_client_.Bind(std::move(client_info));
 }
 
-BatLedgerClientMojoBridge::~BatLedgerClientMojoBridge() = default;
+BatLedgerClientMojoBridge::~BatLedgerClientMojoBridge() {
+  FlushLogRecords();
+}
 
 void OnLoadURL(
     const ledger::client::LoadURLCallback& callback,
@@ -57,7 +68,40 @@ void BatLedgerClientMojoBridge::Log(
     return;
   }
 
-  bat_ledger_client_->Log(file, line, verbose_level, message);
+  log_records_.push_back(
+      mojom::LogRecord::New(file, line, verbose_level, message,
+          base::Time::Now()));
+
+  // Errors are sent right away so that they are not lost if the process goes
+  // away before the next flush
+  if (verbose_level == 0 || log_records_.size() >= kMaxBufferedLogRecords) {
+    FlushLogRecords();
+    return;
+  }
+
+  if (!flush_log_records_timer_.IsRunning()) {
+    flush_log_records_timer_.Start(FROM_HERE,
+        base::TimeDelta::FromMilliseconds(kFlushLogRecordsDelayInMilliseconds),
+        base::BindOnce(&BatLedgerClientMojoBridge::FlushLogRecords,
+            base::Unretained(this)));
+  }
+}
+
+void BatLedgerClientMojoBridge::FlushLogRecords() {
+  flush_log_records_timer_.Stop();
+
+  if (log_records_.empty()) {
+    return;
+  }
+
+  std::vector<mojom::LogRecordPtr> log_records;
+  log_records.swap(log_records_);
+
+  if (!Connected()) {
+    return;
+  }
+
+  bat_ledger_client_->Log(std::move(log_records));
 }
 
 void BatLedgerClientMojoBridge::OnLoadLedgerState(
@@ -386,4 +430,35 @@ std::string BatLedgerClientMojoBridge::GetEncryptedStringState(
   return value;
 }
 
+void OnLoadPublisherPrefixList(
+    const ledger::client::LoadFileCallback callback,
+    const ledger::type::Result result,
+    base::File file) {
+  callback(result, std::move(file));
+}
+
+void BatLedgerClientMojoBridge::SavePublisherPrefixList(
+    const std::string& contents,
+    ledger::client::LoadFileCallback callback) {
+  if (!Connected()) {
+    callback(ledger::type::Result::LEDGER_ERROR, base::File());
+    return;
+  }
+
+  bat_ledger_client_->SavePublisherPrefixList(
+      contents,
+      base::BindOnce(&OnLoadPublisherPrefixList, std::move(callback)));
+}
+
+void BatLedgerClientMojoBridge::LoadPublisherPrefixList(
+    ledger::client::LoadFileCallback callback) {
+  if (!Connected()) {
+    callback(ledger::type::Result::LEDGER_ERROR, base::File());
+    return;
+  }
+
+  bat_ledger_client_->LoadPublisherPrefixList(
+      base::BindOnce(&OnLoadPublisherPrefixList, std::move(callback)));
+}
+
 }  // namespace bat_ledger
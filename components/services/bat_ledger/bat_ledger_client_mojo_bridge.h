@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "base/memory/weak_ptr.h"
+#include "base/timer/timer.h"
 #include "bat/ledger/ledger_client.h"
 #include "brave/components/services/bat_ledger/public/interfaces/bat_ledger.mojom.h"
 #include "mojo/public/cpp/bindings/associated_remote.h"
@@ -124,10 +125,23 @@ class BatLedgerClientMojoBridge :
 
   std::string GetEncryptedStringState(const std::string& name) override;
 
+  void SavePublisherPrefixList(
+      const std::string& contents,
+      ledger::client::LoadFileCallback callback) override;
+
+  void LoadPublisherPrefixList(
+      ledger::client::LoadFileCallback callback) override;
+
  private:
   bool Connected() const;
 
+  // Sends buffered log records to the client in a single message
+  void FlushLogRecords();
+
   mojo::AssociatedRemote<mojom::BatLedgerClient> bat_ledger_client_;
+
+  std::vector<mojom::LogRecordPtr> log_records_;
+  base::OneShotTimer flush_log_records_timer_;
 };
 
 }  // namespace bat_ledger
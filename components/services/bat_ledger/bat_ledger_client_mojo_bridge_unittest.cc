@@ -0,0 +1,126 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/services/bat_ledger/bat_ledger_client_mojo_bridge.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/strings/string_number_conversions.h"
+#include "base/test/task_environment.h"
+#include "base/time/time.h"
+#include "bat/ledger/internal/ledger_client_mock.h"
+#include "brave/components/services/bat_ledger/public/cpp/ledger_client_mojo_bridge.h"
+#include "mojo/public/cpp/bindings/associated_receiver.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=BatLedgerClientMojoBridgeTest.*
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+namespace bat_ledger {
+
+namespace {
+
+struct ReceivedLogRecord {
+  base::Time created_at;
+  int verbose_level;
+  std::string message;
+};
+
+}  // namespace
+
+class BatLedgerClientMojoBridgeTest : public testing::Test {
+ protected:
+  BatLedgerClientMojoBridgeTest()
+      : task_environment_(base::test::TaskEnvironment::TimeSource::MOCK_TIME),
+        ledger_client_mojo_bridge_(&mock_ledger_client_),
+        receiver_(&ledger_client_mojo_bridge_) {
+    ON_CALL(mock_ledger_client_, LogWithTime(_, _, _, _, _))
+        .WillByDefault(Invoke([this](
+            const base::Time created_at,
+            const char* file,
+            const int line,
+            const int verbose_level,
+            const std::string& message) {
+          records_.push_back({created_at, verbose_level, message});
+        }));
+
+    bat_ledger_client_mojo_bridge_ =
+        std::make_unique<BatLedgerClientMojoBridge>(
+            receiver_.BindNewEndpointAndPassDedicatedRemote());
+  }
+
+  void Log(const int verbose_level, const std::string& message) {
+    bat_ledger_client_mojo_bridge_->Log(__FILE__, __LINE__, verbose_level,
+        message);
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  NiceMock<ledger::MockLedgerClient> mock_ledger_client_;
+  LedgerClientMojoBridge ledger_client_mojo_bridge_;
+  mojo::AssociatedReceiver<mojom::BatLedgerClient> receiver_;
+  std::unique_ptr<BatLedgerClientMojoBridge> bat_ledger_client_mojo_bridge_;
+  std::vector<ReceivedLogRecord> records_;
+};
+
+TEST_F(BatLedgerClientMojoBridgeTest, FlushLogRecordsAfterMaxBufferedRecords) {
+  for (int i = 0; i < 99; i++) {
+    Log(1, base::NumberToString(i));
+  }
+  task_environment_.RunUntilIdle();
+  EXPECT_TRUE(records_.empty());
+
+  Log(1, "99");
+  task_environment_.RunUntilIdle();
+  ASSERT_EQ(records_.size(), 100ul);
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(records_.at(i).message, base::NumberToString(i));
+  }
+}
+
+TEST_F(BatLedgerClientMojoBridgeTest, FlushLogRecordsAfterDelay) {
+  Log(1, "first");
+  task_environment_.FastForwardBy(base::TimeDelta::FromMilliseconds(250));
+  Log(1, "second");
+  task_environment_.FastForwardBy(base::TimeDelta::FromMilliseconds(249));
+  EXPECT_TRUE(records_.empty());
+
+  // The delay runs from the first buffered record
+  task_environment_.FastForwardBy(base::TimeDelta::FromMilliseconds(1));
+  ASSERT_EQ(records_.size(), 2ul);
+  EXPECT_EQ(records_.at(0).message, "first");
+  EXPECT_EQ(records_.at(1).message, "second");
+}
+
+TEST_F(BatLedgerClientMojoBridgeTest, FlushLogRecordsOnError) {
+  Log(1, "info");
+  Log(0, "error");
+  task_environment_.RunUntilIdle();
+
+  ASSERT_EQ(records_.size(), 2ul);
+  EXPECT_EQ(records_.at(0).message, "info");
+  EXPECT_EQ(records_.at(1).verbose_level, 0);
+  EXPECT_EQ(records_.at(1).message, "error");
+}
+
+TEST_F(BatLedgerClientMojoBridgeTest, LogRecordsKeepCreationTime) {
+  const base::Time first_created_at = base::Time::Now();
+  Log(1, "first");
+  task_environment_.FastForwardBy(base::TimeDelta::FromMilliseconds(100));
+  const base::Time second_created_at = base::Time::Now();
+  Log(1, "second");
+  task_environment_.FastForwardBy(base::TimeDelta::FromMilliseconds(400));
+
+  ASSERT_EQ(records_.size(), 2ul);
+  EXPECT_EQ(records_.at(0).created_at, first_created_at);
+  EXPECT_EQ(records_.at(1).created_at, second_created_at);
+}
+
+}  // namespace bat_ledger
@@ -62,6 +62,11 @@ void BatLedgerServiceImpl::SetTesting() {
   ledger::is_testing = true;
 }
 
+void BatLedgerServiceImpl::SetLogVerboseLevel(const int32_t verbose_level) {
+  DCHECK(!initialized_ || testing());
+  ledger::log_verbose_level = verbose_level;
+}
+
 void BatLedgerServiceImpl::GetEnvironment(GetEnvironmentCallback callback) {
   std::move(callback).Run(ledger::_environment);
 }
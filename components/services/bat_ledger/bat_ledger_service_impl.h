@@ -39,6 +39,7 @@ class BatLedgerServiceImpl : public mojom::BatLedgerService {
   void SetReconcileInterval(const int32_t interval) override;
   void SetShortRetries(bool short_retries) override;
   void SetTesting() override;
+  void SetLogVerboseLevel(const int32_t verbose_level) override;
 
   void GetEnvironment(GetEnvironmentCallback callback) override;
   void GetDebug(GetDebugCallback callback) override;
@@ -340,11 +340,11 @@ void LedgerClientMojoBridge::PendingContributionSaved(
 }
 
 void LedgerClientMojoBridge::Log(
-    const std::string& file,
-    const int32_t line,
-    const int32_t verbose_level,
-    const std::string& message) {
-  ledger_client_->Log(file.c_str(), line, verbose_level, message);
+    std::vector<mojom::LogRecordPtr> records) {
+  for (const auto& record : records) {
+    ledger_client_->LogWithTime(record->created_at, record->file.c_str(),
+        record->line, record->verbose_level, record->message);
+  }
 }
 
 void LedgerClientMojoBridge::ClearAllNotifications() {
@@ -390,4 +390,54 @@ void LedgerClientMojoBridge::GetEncryptedStringState(
   std::move(callback).Run(ledger_client_->GetEncryptedStringState(name));
 }
 
+// static
+void LedgerClientMojoBridge::OnSavePublisherPrefixList(
+    CallbackHolder<SavePublisherPrefixListCallback>* holder,
+    const ledger::type::Result result,
+    base::File file) {
+  DCHECK(holder);
+  if (holder->is_valid()) {
+    std::move(holder->get()).Run(result, std::move(file));
+  }
+  delete holder;
+}
+
+void LedgerClientMojoBridge::SavePublisherPrefixList(
+    const std::string& contents,
+    SavePublisherPrefixListCallback callback) {
+  auto* holder = new CallbackHolder<SavePublisherPrefixListCallback>(
+      AsWeakPtr(),
+      std::move(callback));
+  ledger_client_->SavePublisherPrefixList(
+      contents,
+      std::bind(LedgerClientMojoBridge::OnSavePublisherPrefixList,
+                holder,
+                _1,
+                _2));
+}
+
+// static
+void LedgerClientMojoBridge::OnLoadPublisherPrefixList(
+    CallbackHolder<LoadPublisherPrefixListCallback>* holder,
+    const ledger::type::Result result,
+    base::File file) {
+  DCHECK(holder);
+  if (holder->is_valid()) {
+    std::move(holder->get()).Run(result, std::move(file));
+  }
+  delete holder;
+}
+
+void LedgerClientMojoBridge::LoadPublisherPrefixList(
+    LoadPublisherPrefixListCallback callback) {
+  auto* holder = new CallbackHolder<LoadPublisherPrefixListCallback>(
+      AsWeakPtr(),
+      std::move(callback));
+  ledger_client_->LoadPublisherPrefixList(
+      std::bind(LedgerClientMojoBridge::OnLoadPublisherPrefixList,
+                holder,
+                _1,
+                _2));
+}
+
 }  // namespace bat_ledger
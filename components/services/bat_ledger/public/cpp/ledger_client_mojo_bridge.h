@@ -121,11 +121,7 @@ class LedgerClientMojoBridge :
 
   void PendingContributionSaved(const ledger::type::Result result) override;
 
-  void Log(
-      const std::string& file,
-      const int32_t line,
-      const int32_t verbose_level,
-      const std::string& message) override;
+  void Log(std::vector<mojom::LogRecordPtr> records) override;
 
   void ClearAllNotifications() override;
 
@@ -142,6 +138,13 @@ class LedgerClientMojoBridge :
       const std::string& name,
       GetEncryptedStringStateCallback callback) override;
 
+  void SavePublisherPrefixList(
+      const std::string& contents,
+      SavePublisherPrefixListCallback callback) override;
+
+  void LoadPublisherPrefixList(
+      LoadPublisherPrefixListCallback callback) override;
+
  private:
   // workaround to pass base::OnceCallback into std::bind
   template <typename Callback>
@@ -196,6 +199,16 @@ class LedgerClientMojoBridge :
       CallbackHolder<DeleteLogCallback>* holder,
       const ledger::type::Result result);
 
+  static void OnSavePublisherPrefixList(
+      CallbackHolder<SavePublisherPrefixListCallback>* holder,
+      const ledger::type::Result result,
+      base::File file);
+
+  static void OnLoadPublisherPrefixList(
+      CallbackHolder<LoadPublisherPrefixListCallback>* holder,
+      const ledger::type::Result result,
+      base::File file);
+
   ledger::LedgerClient* ledger_client_;
 };
 
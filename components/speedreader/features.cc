@@ -19,4 +19,14 @@ const base::Feature kSpeedreaderFeature {
 #endif
 };
 
+// Distill response bodies while they are still arriving instead of buffering
+// the whole document first.
+const base::Feature kSpeedreaderStreamingFeature{
+    "SpeedreaderStreaming", base::FEATURE_ENABLED_BY_DEFAULT};
+
+// Look at the start of the document and pass pages that don't look like
+// articles through without running the rewriter.
+const base::Feature kSpeedreaderReadabilityPrecheckFeature{
+    "SpeedreaderReadabilityPrecheck", base::FEATURE_ENABLED_BY_DEFAULT};
+
 }  // namespace speedreader
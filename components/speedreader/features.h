@@ -12,6 +12,8 @@ struct Feature;
 
 namespace speedreader {
 extern const base::Feature kSpeedreaderFeature;
+extern const base::Feature kSpeedreaderStreamingFeature;
+extern const base::Feature kSpeedreaderReadabilityPrecheckFeature;
 }  // namespace speedreader
 
 #endif  // BRAVE_COMPONENTS_SPEEDREADER_FEATURES_H_
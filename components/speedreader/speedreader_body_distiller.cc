@@ -0,0 +1,250 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/speedreader/speedreader_body_distiller.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/compiler_specific.h"
+#include "base/feature_list.h"
+#include "base/logging.h"
+#include "base/sequence_checker.h"
+#include "base/task/post_task.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "brave/components/speedreader/features.h"
+#include "brave/components/speedreader/rust/ffi/speedreader.h"
+#include "brave/components/speedreader/speedreader_readability_precheck.h"
+#include "brave/components/speedreader/speedreader_rewriter_service.h"
+#include "url/gurl.h"
+
+namespace speedreader {
+
+// Owns the rewriter and lives on |distill_task_runner_|.
+class SpeedreaderBodyDistiller::Core {
+ public:
+  Core(const GURL& url,
+       SpeedreaderRewriterService* rewriter_service,
+       scoped_refptr<base::SequencedTaskRunner> reply_task_runner,
+       OutputCallback output_callback,
+       CompleteCallback complete_callback)
+      : state_(base::FeatureList::IsEnabled(
+                   kSpeedreaderReadabilityPrecheckFeature)
+                   ? State::kPrechecking
+                   : State::kUndecided),
+        stylesheet_(rewriter_service->GetContentStylesheet()),
+        reply_task_runner_(std::move(reply_task_runner)),
+        output_callback_(std::move(output_callback)),
+        complete_callback_(std::move(complete_callback)) {
+    // The rewriter is created on the owner sequence but only used on the
+    // distilling one.
+    DETACH_FROM_SEQUENCE(sequence_checker_);
+    rewriter_ = rewriter_service->MakeRewriter(url, &Core::OnRewriterOutput,
+                                               this);
+  }
+
+  Core(const Core&) = delete;
+  Core& operator=(const Core&) = delete;
+
+  ~Core() { DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_); }
+
+  void Write(std::string chunk) {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    switch (state_) {
+      case State::kPassThrough:
+        Reply(std::move(chunk));
+        return;
+      case State::kFailed:
+        return;
+      case State::kPrechecking:
+        original_.append(chunk);
+        UpdatePeakBufferedBytes();
+        switch (precheck_.Feed(chunk)) {
+          case SpeedreaderReadabilityPrecheck::Result::kUndecided:
+            return;
+          case SpeedreaderReadabilityPrecheck::Result::kNotReadable:
+            PassThrough();
+            return;
+          case SpeedreaderReadabilityPrecheck::Result::kReadable:
+          case SpeedreaderReadabilityPrecheck::Result::kInconclusive:
+            // Catch the rewriter up on everything received so far.
+            state_ = State::kUndecided;
+            Rewrite(original_);
+            return;
+        }
+        return;
+      case State::kUndecided:
+        original_.append(chunk);
+        UpdatePeakBufferedBytes();
+        FALLTHROUGH;
+      case State::kDistilling:
+        Rewrite(chunk);
+        return;
+    }
+  }
+
+  void End() {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    if (state_ == State::kPrechecking) {
+      if (precheck_.End() ==
+          SpeedreaderReadabilityPrecheck::Result::kNotReadable) {
+        PassThrough();
+      } else {
+        state_ = State::kUndecided;
+        Rewrite(original_);
+      }
+    }
+    if (state_ == State::kUndecided || state_ == State::kDistilling)
+      rewriter_->End();
+
+    bool distilled = state_ == State::kDistilling;
+    if (state_ == State::kUndecided) {
+      if (output_.length() >= kMinDistilledOutputSize) {
+        Reply(stylesheet_ + output_);
+        distilled = true;
+      } else {
+        Reply(std::move(original_));
+      }
+    } else if (state_ == State::kDistilling && !output_.empty()) {
+      Reply(std::move(output_));
+    }
+    output_.clear();
+    original_.clear();
+
+    reply_task_runner_->PostTask(
+        FROM_HERE, base::BindOnce(std::move(complete_callback_), distilled));
+  }
+
+  size_t peak_buffered_bytes() const { return peak_buffered_bytes_; }
+
+ private:
+  enum class State {
+    // The readability pre-check hasn't decided yet. The original body is kept
+    // and the rewriter isn't fed.
+    kPrechecking,
+    // Output is withheld and the original body is kept.
+    kUndecided,
+    // Enough distilled output was produced; it is streamed as it comes.
+    kDistilling,
+    // The page isn't readable or the rewriter failed before committing; input
+    // is forwarded untouched.
+    kPassThrough,
+    // The rewriter failed after committing; remaining input is dropped.
+    kFailed,
+  };
+
+  static void OnRewriterOutput(const char* chunk,
+                               size_t chunk_len,
+                               void* user_data) {
+    Core* core = static_cast<Core*>(user_data);
+    core->output_.append(chunk, chunk_len);
+    core->UpdatePeakBufferedBytes();
+  }
+
+  void UpdatePeakBufferedBytes() {
+    peak_buffered_bytes_ = std::max(peak_buffered_bytes_,
+                                    original_.capacity() + output_.capacity());
+  }
+
+  void Rewrite(const std::string& data) {
+    if (rewriter_->Write(data.data(), data.length()) != 0) {
+      // Error occurred
+      if (state_ == State::kUndecided) {
+        VLOG(2) << __func__ << " rewriter failed, passing original through";
+        PassThrough();
+      } else {
+        // Distilled output has already been sent, so the original can't be
+        // used anymore. Finish with what has been produced so far.
+        VLOG(2) << __func__ << " rewriter failed after committing";
+        state_ = State::kFailed;
+      }
+      return;
+    }
+    MaybeFlushOutput();
+  }
+
+  void PassThrough() {
+    state_ = State::kPassThrough;
+    Reply(std::move(original_));
+    original_.clear();
+  }
+
+  void MaybeFlushOutput() {
+    if (state_ == State::kUndecided) {
+      if (output_.length() < kMinDistilledOutputSize)
+        return;
+      state_ = State::kDistilling;
+      original_.clear();
+      original_.shrink_to_fit();
+      Reply(stylesheet_ + output_);
+      output_.clear();
+      return;
+    }
+    if (!output_.empty()) {
+      Reply(std::move(output_));
+      output_.clear();
+    }
+  }
+
+  void Reply(std::string data) {
+    if (data.empty())
+      return;
+    reply_task_runner_->PostTask(
+        FROM_HERE, base::BindOnce(output_callback_, std::move(data)));
+  }
+
+  State state_;
+  SpeedreaderReadabilityPrecheck precheck_;
+  std::unique_ptr<Rewriter> rewriter_;
+  const std::string stylesheet_;
+
+  // Body received so far, kept until distilled output is committed.
+  std::string original_;
+  // Rewriter output not handed out yet.
+  std::string output_;
+  size_t peak_buffered_bytes_ = 0;
+
+  scoped_refptr<base::SequencedTaskRunner> reply_task_runner_;
+  OutputCallback output_callback_;
+  CompleteCallback complete_callback_;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+};
+
+SpeedreaderBodyDistiller::SpeedreaderBodyDistiller(
+    const GURL& url,
+    SpeedreaderRewriterService* rewriter_service,
+    OutputCallback output_callback,
+    CompleteCallback complete_callback)
+    : distill_task_runner_(base::CreateSequencedTaskRunner(
+          {base::ThreadPool(), base::TaskPriority::USER_BLOCKING})),
+      core_(new Core(url,
+                     rewriter_service,
+                     base::SequencedTaskRunnerHandle::Get(),
+                     std::move(output_callback),
+                     std::move(complete_callback)),
+            base::OnTaskRunnerDeleter(distill_task_runner_)) {}
+
+SpeedreaderBodyDistiller::~SpeedreaderBodyDistiller() = default;
+
+void SpeedreaderBodyDistiller::Write(std::string chunk) {
+  // |core_| is deleted on |distill_task_runner_| after any pending task.
+  distill_task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(&Core::Write, base::Unretained(core_.get()),
+                                std::move(chunk)));
+}
+
+void SpeedreaderBodyDistiller::End() {
+  distill_task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(&Core::End, base::Unretained(core_.get())));
+}
+
+size_t SpeedreaderBodyDistiller::peak_buffered_bytes_for_testing() const {
+  // |core_| is done with its sequence once |complete_callback| has run.
+  return core_->peak_buffered_bytes();
+}
+
+}  // namespace speedreader
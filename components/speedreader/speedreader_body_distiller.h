@@ -0,0 +1,76 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_BODY_DISTILLER_H_
+#define BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_BODY_DISTILLER_H_
+
+#include <memory>
+#include <string>
+
+#include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/sequenced_task_runner.h"
+
+class GURL;
+
+namespace speedreader {
+
+class SpeedreaderRewriterService;
+
+// Distilled output shorter than this is considered a failure to find content
+// and the original page is used instead.
+// TODO(brave-browser/issues/10372): would be better to pass explicit signal
+// back from rewriter to indicate if content was found
+constexpr size_t kMinDistilledOutputSize = 1024;
+
+// Runs a Speedreader |Rewriter| over a response body while it is still
+// arriving. Chunks passed to Write() are pumped through the rewriter on a
+// background sequence, and whatever is ready to be sent to the renderer is
+// handed back to |output_callback| on the sequence that created the distiller.
+//
+// The rewriter is only fed once SpeedreaderReadabilityPrecheck has not ruled
+// the page out; pages it rules out are passed through as soon as that is known.
+// Output is held back until the rewriter has produced at least
+// |kMinDistilledOutputSize| bytes. Until then the original bytes are kept, so
+// that pages which can't be distilled are passed through unchanged.
+class SpeedreaderBodyDistiller {
+ public:
+  using OutputCallback = base::RepeatingCallback<void(std::string data)>;
+  // |distilled| is false if the original body was passed through or the
+  // rewriter failed part way.
+  using CompleteCallback = base::OnceCallback<void(bool distilled)>;
+
+  // |rewriter_service| is only used during construction.
+  SpeedreaderBodyDistiller(const GURL& url,
+                           SpeedreaderRewriterService* rewriter_service,
+                           OutputCallback output_callback,
+                           CompleteCallback complete_callback);
+  ~SpeedreaderBodyDistiller();
+
+  SpeedreaderBodyDistiller(const SpeedreaderBodyDistiller&) = delete;
+  SpeedreaderBodyDistiller& operator=(const SpeedreaderBodyDistiller&) =
+      delete;
+
+  // Feeds the next chunk of the response body.
+  void Write(std::string chunk);
+
+  // Signals the end of the response body. |complete_callback| runs after the
+  // last piece of output has been handed to |output_callback|.
+  void End();
+
+  // Largest amount of memory held by the original body and the distilled
+  // output buffers at any one time. Only valid once |complete_callback| ran.
+  size_t peak_buffered_bytes_for_testing() const;
+
+ private:
+  class Core;
+
+  scoped_refptr<base::SequencedTaskRunner> distill_task_runner_;
+  std::unique_ptr<Core, base::OnTaskRunnerDeleter> core_;
+};
+
+}  // namespace speedreader
+
+#endif  // BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_BODY_DISTILLER_H_
@@ -0,0 +1,247 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/speedreader/speedreader_body_distiller.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/path_service.h"
+#include "base/run_loop.h"
+#include "base/strings/string_piece.h"
+#include "base/test/scoped_feature_list.h"
+#include "base/test/task_environment.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "brave/common/brave_paths.h"
+#include "brave/components/speedreader/features.h"
+#include "brave/components/speedreader/rust/ffi/speedreader.h"
+#include "brave/components/speedreader/speedreader_rewriter_service.h"
+#include "brave/components/speedreader/speedreader_switches.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "url/gurl.h"
+
+// npm run test -- brave_speedreader_perftests
+
+// Distills local article fixtures the way SpeedReaderURLLoader does, buffering
+// the whole body or streaming it through SpeedreaderBodyDistiller. Memory is
+// the peak size of the body and output buffers held for the page.
+
+namespace speedreader {
+
+namespace {
+
+const char kTestWhitelist[] = "speedreader_whitelist.json";
+
+// Body chunks are handed over at most this size, like a data pipe does.
+constexpr size_t kChunkSize = 64 * 1024;
+
+constexpr int kIterations = 3;
+
+constexpr char kRepeatStart[] = "<!-- repeat-start -->";
+constexpr char kRepeatEnd[] = "<!-- repeat-end -->";
+
+constexpr char kMetricDistillTime[] = ".distill_time";
+constexpr char kMetricFirstOutputTime[] = ".first_output_time";
+constexpr char kMetricPeakBuffered[] = ".peak_buffered";
+constexpr char kMetricOutputSize[] = ".output_size";
+
+struct Fixture {
+  const char* name;
+  const char* file;
+  // The section between the repeat markers is repeated this many times, to
+  // get large pages without checking them in.
+  int scale;
+  // The whitelisted host gets the declarative rewriter, others the
+  // readability heuristics.
+  const char* url;
+};
+
+constexpr Fixture kFixtures[] = {
+    {"10KB", "speedreader/benchmark/article_10k.html", 1,
+     "https://example.com/news/2020/10/transit-budget"},
+    {"100KB", "speedreader/benchmark/article_100k.html", 1,
+     "https://example.com/news/2020/10/transit-construction"},
+    {"guardian", "guardian.html", 1,
+     "https://www.theguardian.com/world/2020/jun/27/coronavirus"},
+    {"1MB", "speedreader/benchmark/article_100k.html", 10,
+     "https://example.com/news/2020/10/transit-construction"},
+    {"5MB", "speedreader/benchmark/article_100k.html", 50,
+     "https://example.com/news/2020/10/transit-construction"},
+};
+
+struct Measurement {
+  base::TimeDelta total;
+  base::TimeDelta first_output;
+  size_t peak_buffered_bytes = 0;
+  size_t output_size = 0;
+};
+
+base::FilePath GetTestDataDir() {
+  base::FilePath test_data_dir;
+  base::PathService::Get(brave::DIR_TEST_DATA, &test_data_dir);
+  return test_data_dir;
+}
+
+std::string LoadFixture(const Fixture& fixture) {
+  std::string html;
+  EXPECT_TRUE(base::ReadFileToString(
+      GetTestDataDir().AppendASCII(fixture.file), &html));
+  if (fixture.scale <= 1)
+    return html;
+
+  const size_t start = html.find(kRepeatStart);
+  const size_t end = html.find(kRepeatEnd);
+  EXPECT_NE(std::string::npos, start);
+  EXPECT_NE(std::string::npos, end);
+  const std::string section = html.substr(start, end - start);
+  std::string scaled = html.substr(0, start);
+  for (int i = 0; i < fixture.scale; ++i)
+    scaled += section;
+  scaled += html.substr(end);
+  return scaled;
+}
+
+}  // namespace
+
+class SpeedreaderBodyDistillerPerfTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    feature_list_.InitWithFeatures({kSpeedreaderFeature},
+                                   {kSpeedreaderReadabilityPrecheckFeature});
+
+    base::CommandLine::ForCurrentProcess()->AppendSwitchPath(
+        kSpeedreaderWhitelistPath,
+        GetTestDataDir().AppendASCII(kTestWhitelist));
+    // The whitelist is only read from the switch, so no component updater is
+    // needed.
+    rewriter_service_ = std::make_unique<SpeedreaderRewriterService>(nullptr);
+    // Let the whitelist load.
+    task_environment_.RunUntilIdle();
+    ASSERT_TRUE(rewriter_service_->IsWhitelisted(GURL(kFixtures[2].url)));
+  }
+
+  // Buffers the whole body before distilling it in one go, like
+  // SpeedReaderURLLoader does without kSpeedreaderStreamingFeature.
+  Measurement RunBuffered(const std::string& html, const GURL& url) {
+    Measurement measurement;
+    const base::ElapsedTimer timer;
+
+    std::string body;
+    for (size_t offset = 0; offset < html.size(); offset += kChunkSize)
+      body.append(html, offset, kChunkSize);
+
+    std::unique_ptr<Rewriter> rewriter = rewriter_service_->MakeRewriter(url);
+    EXPECT_EQ(0, rewriter->Write(body.data(), body.length()));
+    rewriter->End();
+    const std::string& transformed = rewriter->GetOutput();
+    const std::string output =
+        rewriter_service_->GetContentStylesheet() + transformed;
+
+    measurement.total = timer.Elapsed();
+    // Nothing is sent before the page has been distilled.
+    measurement.first_output = measurement.total;
+    measurement.peak_buffered_bytes =
+        body.capacity() + transformed.capacity() + output.capacity();
+    measurement.output_size = output.size();
+    return measurement;
+  }
+
+  // Streams the body through SpeedreaderBodyDistiller, like
+  // SpeedReaderURLLoader does with kSpeedreaderStreamingFeature.
+  Measurement RunStreaming(const std::string& html, const GURL& url) {
+    Measurement measurement;
+    base::RunLoop run_loop;
+    const base::ElapsedTimer timer;
+
+    SpeedreaderBodyDistiller distiller(
+        url, rewriter_service_.get(),
+        base::BindRepeating(
+            [](const base::ElapsedTimer* timer, Measurement* measurement,
+               std::string data) {
+              if (measurement->output_size == 0)
+                measurement->first_output = timer->Elapsed();
+              measurement->output_size += data.size();
+            },
+            &timer, &measurement),
+        base::BindOnce(
+            [](const base::ElapsedTimer* timer, Measurement* measurement,
+               base::OnceClosure done, bool distilled) {
+              EXPECT_TRUE(distilled);
+              measurement->total = timer->Elapsed();
+              std::move(done).Run();
+            },
+            &timer, &measurement, run_loop.QuitClosure()));
+
+    base::StringPiece remaining(html);
+    while (!remaining.empty()) {
+      const base::StringPiece chunk = remaining.substr(0, kChunkSize);
+      distiller.Write(chunk.as_string());
+      remaining.remove_prefix(chunk.size());
+    }
+    distiller.End();
+    run_loop.Run();
+
+    measurement.peak_buffered_bytes =
+        distiller.peak_buffered_bytes_for_testing();
+    return measurement;
+  }
+
+  void Report(const Fixture& fixture,
+              const std::string& pipeline,
+              const Measurement& measurement) {
+    perf_test::PerfResultReporter reporter(
+        "SpeedreaderDistiller", std::string(fixture.name) + "_" + pipeline);
+    reporter.RegisterImportantMetric(kMetricDistillTime, "ms");
+    reporter.RegisterImportantMetric(kMetricFirstOutputTime, "ms");
+    reporter.RegisterImportantMetric(kMetricPeakBuffered, "bytes");
+    reporter.RegisterImportantMetric(kMetricOutputSize, "bytes");
+
+    reporter.AddResult(kMetricDistillTime, measurement.total);
+    reporter.AddResult(kMetricFirstOutputTime, measurement.first_output);
+    reporter.AddResult(kMetricPeakBuffered,
+                       static_cast<size_t>(measurement.peak_buffered_bytes));
+    reporter.AddResult(kMetricOutputSize,
+                       static_cast<size_t>(measurement.output_size));
+  }
+
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::MainThreadType::IO};
+  base::test::ScopedFeatureList feature_list_;
+  std::unique_ptr<SpeedreaderRewriterService> rewriter_service_;
+};
+
+TEST_F(SpeedreaderBodyDistillerPerfTest, Distill) {
+  for (const auto& fixture : kFixtures) {
+    const std::string html = LoadFixture(fixture);
+    ASSERT_FALSE(html.empty()) << fixture.name;
+    const GURL url(fixture.url);
+
+    // Keep the fastest run; the first one also warms up the allocator.
+    Measurement buffered;
+    Measurement streaming;
+    for (int i = 0; i < kIterations; ++i) {
+      Measurement run = RunBuffered(html, url);
+      if (i == 0 || run.total < buffered.total)
+        buffered = run;
+      run = RunStreaming(html, url);
+      if (i == 0 || run.total < streaming.total)
+        streaming = run;
+    }
+    EXPECT_GE(buffered.output_size, kMinDistilledOutputSize) << fixture.name;
+    EXPECT_GE(streaming.output_size, kMinDistilledOutputSize) << fixture.name;
+
+    Report(fixture, "buffered", buffered);
+    Report(fixture, "streaming", streaming);
+  }
+}
+
+}  // namespace speedreader
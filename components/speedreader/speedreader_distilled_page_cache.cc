@@ -0,0 +1,202 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/speedreader/speedreader_distilled_page_cache.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/logging.h"
+#include "base/metrics/histogram_macros.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/task/post_task.h"
+#include "crypto/sha2.h"
+#include "net/http/http_response_headers.h"
+#include "url/gurl.h"
+
+namespace speedreader {
+
+namespace {
+
+void ResetCacheDirectory(const base::FilePath& cache_dir) {
+  base::DeletePathRecursively(cache_dir);
+  if (!base::CreateDirectory(cache_dir))
+    VLOG(1) << "Failed to create Speedreader cache at " << cache_dir;
+}
+
+base::Optional<std::string> ReadEntry(const base::FilePath& path) {
+  std::string distilled;
+  if (!base::ReadFileToString(path, &distilled))
+    return base::nullopt;
+  return distilled;
+}
+
+void WriteEntry(const base::FilePath& path, const std::string& distilled) {
+  if (base::WriteFile(path, distilled.data(), distilled.size()) !=
+      static_cast<int>(distilled.size())) {
+    VLOG(1) << "Failed to write Speedreader cache entry " << path;
+    base::DeleteFile(path);
+  }
+}
+
+void DeleteEntry(const base::FilePath& path) {
+  base::DeleteFile(path);
+}
+
+// Whether the response may differ between users or carries credentials.
+bool IsPrivateResponse(const net::HttpResponseHeaders& headers) {
+  if (headers.HasHeaderValue("cache-control", "no-store") ||
+      headers.HasHeaderValue("cache-control", "private") ||
+      headers.HasHeader("set-cookie")) {
+    return true;
+  }
+  size_t iter = 0;
+  std::string vary;
+  while (headers.EnumerateHeader(&iter, "vary", &vary)) {
+    if (vary == "*" || base::EqualsCaseInsensitiveASCII(vary, "cookie") ||
+        base::EqualsCaseInsensitiveASCII(vary, "authorization")) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+SpeedreaderDistilledPageCache::SpeedreaderDistilledPageCache(
+    const base::FilePath& cache_dir,
+    size_t max_size_bytes)
+    : cache_dir_(cache_dir),
+      max_size_bytes_(max_size_bytes),
+      file_task_runner_(base::CreateSequencedTaskRunner(
+          {base::ThreadPool(), base::MayBlock(),
+           base::TaskPriority::USER_VISIBLE,
+           base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})),
+      entries_(decltype(entries_)::NO_AUTO_EVICT) {
+  file_task_runner_->PostTask(FROM_HERE,
+                              base::BindOnce(&ResetCacheDirectory, cache_dir_));
+}
+
+SpeedreaderDistilledPageCache::~SpeedreaderDistilledPageCache() = default;
+
+// static
+std::string SpeedreaderDistilledPageCache::GetKey(
+    const GURL& url,
+    const net::HttpResponseHeaders* headers,
+    const std::string& rewriter_version) {
+  if (!headers || !url.is_valid() || IsPrivateResponse(*headers))
+    return std::string();
+  std::string etag;
+  std::string last_modified;
+  headers->EnumerateHeader(nullptr, "etag", &etag);
+  headers->EnumerateHeader(nullptr, "last-modified", &last_modified);
+  if (etag.empty() && last_modified.empty())
+    return std::string();
+
+  GURL::Replacements remove_ref;
+  remove_ref.ClearRef();
+  return url.ReplaceComponents(remove_ref).spec() + '\n' + etag + '\n' +
+         last_modified + '\n' + rewriter_version;
+}
+
+void SpeedreaderDistilledPageCache::Get(const std::string& key,
+                                        GetCallback callback) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  const std::string file_name =
+      base::HexEncode(crypto::SHA256HashString(key).data(),
+                      crypto::kSHA256Length);
+  auto it = entries_.Get(file_name);
+  if (it == entries_.end()) {
+    miss_count_++;
+    UMA_HISTOGRAM_BOOLEAN("Brave.Speedreader.DistilledPageCacheHit", false);
+    std::move(callback).Run(base::nullopt);
+    return;
+  }
+  base::PostTaskAndReplyWithResult(
+      file_task_runner_.get(), FROM_HERE,
+      base::BindOnce(&ReadEntry, cache_dir_.AppendASCII(file_name)),
+      base::BindOnce(&SpeedreaderDistilledPageCache::OnRead,
+                     weak_factory_.GetWeakPtr(), file_name,
+                     std::move(callback)));
+}
+
+void SpeedreaderDistilledPageCache::OnRead(
+    const std::string& file_name,
+    GetCallback callback,
+    base::Optional<std::string> distilled) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!distilled) {
+    // The entry was evicted or the directory was cleared in the meantime.
+    Evict(file_name);
+    miss_count_++;
+  } else {
+    hit_count_++;
+  }
+  UMA_HISTOGRAM_BOOLEAN("Brave.Speedreader.DistilledPageCacheHit",
+                        distilled.has_value());
+  std::move(callback).Run(std::move(distilled));
+}
+
+void SpeedreaderDistilledPageCache::Put(const std::string& key,
+                                        std::string distilled) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (key.empty() || distilled.size() > max_size_bytes_)
+    return;
+  const std::string file_name =
+      base::HexEncode(crypto::SHA256HashString(key).data(),
+                      crypto::kSHA256Length);
+  Evict(file_name);
+  while (!entries_.empty() &&
+         size_bytes_ + distilled.size() > max_size_bytes_) {
+    Evict(entries_.rbegin()->first);
+  }
+  entries_.Put(file_name, distilled.size());
+  size_bytes_ += distilled.size();
+  file_task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(&WriteEntry, cache_dir_.AppendASCII(file_name),
+                                std::move(distilled)));
+}
+
+void SpeedreaderDistilledPageCache::Clear() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (entries_.empty())
+    return;
+  VLOG(2) << __func__ << " evicting " << entries_.size() << " entries";
+  entries_.Clear();
+  size_bytes_ = 0;
+  file_task_runner_->PostTask(FROM_HERE,
+                              base::BindOnce(&ResetCacheDirectory, cache_dir_));
+}
+
+void SpeedreaderDistilledPageCache::SetRewriterVersion(
+    const std::string& rewriter_version) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (rewriter_version == rewriter_version_)
+    return;
+  rewriter_version_ = rewriter_version;
+  Clear();
+}
+
+void SpeedreaderDistilledPageCache::RecordBytesSaved(size_t bytes) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  bytes_saved_ += bytes;
+  UMA_HISTOGRAM_MEMORY_KB("Brave.Speedreader.DistilledPageCacheBytesSaved",
+                          bytes / 1024);
+}
+
+void SpeedreaderDistilledPageCache::Evict(const std::string& file_name) {
+  auto it = entries_.Peek(file_name);
+  if (it == entries_.end())
+    return;
+  size_bytes_ -= it->second;
+  entries_.Erase(it);
+  file_task_runner_->PostTask(
+      FROM_HERE,
+      base::BindOnce(&DeleteEntry, cache_dir_.AppendASCII(file_name)));
+}
+
+}  // namespace speedreader
@@ -0,0 +1,102 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_DISTILLED_PAGE_CACHE_H_
+#define BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_DISTILLED_PAGE_CACHE_H_
+
+#include <string>
+
+#include "base/callback.h"
+#include "base/containers/mru_cache.h"
+#include "base/files/file_path.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/optional.h"
+#include "base/sequence_checker.h"
+#include "base/sequenced_task_runner.h"
+
+class GURL;
+
+namespace net {
+class HttpResponseHeaders;
+}  // namespace net
+
+namespace speedreader {
+
+// Size-bounded on-disk cache of distilled pages for one profile, so that
+// reloads, back/forward navigations and revisits of an article can be served
+// without running the rewriter again. Off-the-record profiles have none.
+//
+// Entries are keyed by URL, response validators (ETag/Last-Modified) and the
+// version of the rewriter and stylesheet that produced them. The index lives in
+// memory on the owning sequence, so misses never touch the disk; file I/O runs
+// on a background sequence. The cache directory is wiped when the cache is
+// created, so entries only live for a browsing session.
+class SpeedreaderDistilledPageCache {
+ public:
+  using GetCallback =
+      base::OnceCallback<void(base::Optional<std::string> distilled)>;
+
+  SpeedreaderDistilledPageCache(const base::FilePath& cache_dir,
+                                size_t max_size_bytes);
+  ~SpeedreaderDistilledPageCache();
+
+  SpeedreaderDistilledPageCache(const SpeedreaderDistilledPageCache&) = delete;
+  SpeedreaderDistilledPageCache& operator=(
+      const SpeedreaderDistilledPageCache&) = delete;
+
+  // Returns the cache key for a response, or an empty string if the response
+  // must not be cached: it has no validators, is marked no-store or private,
+  // varies on credentials or sets cookies.
+  static std::string GetKey(const GURL& url,
+                            const net::HttpResponseHeaders* headers,
+                            const std::string& rewriter_version);
+
+  // Runs |callback| with the cached distilled page for |key|, or with
+  // base::nullopt on a miss.
+  void Get(const std::string& key, GetCallback callback);
+  void Put(const std::string& key, std::string distilled);
+
+  // Drops every entry.
+  void Clear();
+
+  // Drops every entry if |rewriter_version| differs from the version of the
+  // rewriter and stylesheet the cached pages were distilled with.
+  void SetRewriterVersion(const std::string& rewriter_version);
+
+  // Records that a hit saved distilling |bytes| of original body.
+  void RecordBytesSaved(size_t bytes);
+
+  size_t hit_count() const { return hit_count_; }
+  size_t miss_count() const { return miss_count_; }
+  uint64_t bytes_saved() const { return bytes_saved_; }
+  size_t size_bytes() const { return size_bytes_; }
+
+ private:
+  void OnRead(const std::string& file_name,
+              GetCallback callback,
+              base::Optional<std::string> distilled);
+  void Evict(const std::string& file_name);
+
+  const base::FilePath cache_dir_;
+  const size_t max_size_bytes_;
+  scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+
+  // Maps file names (hashed keys) to entry sizes, most recently used first.
+  base::MRUCache<std::string, size_t> entries_;
+  size_t size_bytes_ = 0;
+  std::string rewriter_version_;
+
+  size_t hit_count_ = 0;
+  size_t miss_count_ = 0;
+  uint64_t bytes_saved_ = 0;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+  base::WeakPtrFactory<SpeedreaderDistilledPageCache> weak_factory_{this};
+};
+
+}  // namespace speedreader
+
+#endif  // BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_DISTILLED_PAGE_CACHE_H_
@@ -0,0 +1,162 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/speedreader/speedreader_distilled_page_cache.h"
+
+#include <string>
+
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/optional.h"
+#include "base/run_loop.h"
+#include "base/test/task_environment.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace speedreader {
+
+namespace {
+
+scoped_refptr<net::HttpResponseHeaders> MakeHeaders(const std::string& raw) {
+  return base::MakeRefCounted<net::HttpResponseHeaders>(
+      net::HttpUtil::AssembleRawHeaders(raw));
+}
+
+}  // namespace
+
+class SpeedreaderDistilledPageCacheTest : public testing::Test {
+ public:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    cache_ = std::make_unique<SpeedreaderDistilledPageCache>(
+        temp_dir_.GetPath().AppendASCII("cache"), 1000);
+  }
+
+  base::Optional<std::string> Get(const std::string& key) {
+    base::Optional<std::string> result;
+    base::RunLoop run_loop;
+    cache_->Get(key, base::BindOnce(
+                         [](base::Optional<std::string>* result,
+                            base::OnceClosure quit,
+                            base::Optional<std::string> distilled) {
+                           *result = std::move(distilled);
+                           std::move(quit).Run();
+                         },
+                         &result, run_loop.QuitClosure()));
+    run_loop.Run();
+    return result;
+  }
+
+ protected:
+  base::test::TaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+  std::unique_ptr<SpeedreaderDistilledPageCache> cache_;
+};
+
+TEST_F(SpeedreaderDistilledPageCacheTest, KeyRequiresValidators) {
+  const GURL url("https://example.com/article#section");
+  EXPECT_TRUE(SpeedreaderDistilledPageCache::GetKey(
+                  url, MakeHeaders("HTTP/1.1 200 OK\n").get(), "1")
+                  .empty());
+  EXPECT_TRUE(SpeedreaderDistilledPageCache::GetKey(
+                  url,
+                  MakeHeaders("HTTP/1.1 200 OK\nETag: \"a\"\n"
+                              "Cache-Control: no-store\n")
+                      .get(),
+                  "1")
+                  .empty());
+
+  const std::string key = SpeedreaderDistilledPageCache::GetKey(
+      url, MakeHeaders("HTTP/1.1 200 OK\nETag: \"a\"\n").get(), "1");
+  EXPECT_FALSE(key.empty());
+  // The fragment doesn't matter, but validators and versions do.
+  EXPECT_EQ(key, SpeedreaderDistilledPageCache::GetKey(
+                     GURL("https://example.com/article"),
+                     MakeHeaders("HTTP/1.1 200 OK\nETag: \"a\"\n").get(), "1"));
+  EXPECT_NE(key, SpeedreaderDistilledPageCache::GetKey(
+                     url, MakeHeaders("HTTP/1.1 200 OK\nETag: \"b\"\n").get(),
+                     "1"));
+  EXPECT_NE(key, SpeedreaderDistilledPageCache::GetKey(
+                     url, MakeHeaders("HTTP/1.1 200 OK\nETag: \"a\"\n").get(),
+                     "2"));
+}
+
+TEST_F(SpeedreaderDistilledPageCacheTest, KeyRefusesPrivateResponses) {
+  const GURL url("https://example.com/article");
+  const char* kPrivateHeaders[] = {
+      "Cache-Control: private, max-age=60\n",
+      "Vary: *\n",
+      "Vary: Accept-Encoding, Cookie\n",
+      "Vary: authorization\n",
+      "Set-Cookie: session=1\n",
+  };
+  for (const char* private_header : kPrivateHeaders) {
+    EXPECT_TRUE(SpeedreaderDistilledPageCache::GetKey(
+                    url,
+                    MakeHeaders(std::string("HTTP/1.1 200 OK\nETag: \"a\"\n") +
+                                private_header)
+                        .get(),
+                    "1")
+                    .empty())
+        << private_header;
+  }
+
+  EXPECT_FALSE(SpeedreaderDistilledPageCache::GetKey(
+                   url,
+                   MakeHeaders("HTTP/1.1 200 OK\nETag: \"a\"\n"
+                               "Cache-Control: public\n"
+                               "Vary: Accept-Encoding\n")
+                       .get(),
+                   "1")
+                   .empty());
+}
+
+TEST_F(SpeedreaderDistilledPageCacheTest, HitAndMiss) {
+  EXPECT_FALSE(Get("key"));
+  cache_->Put("key", "distilled");
+  EXPECT_EQ("distilled", Get("key"));
+  EXPECT_EQ(1u, cache_->hit_count());
+  EXPECT_EQ(1u, cache_->miss_count());
+
+  cache_->RecordBytesSaved(4096);
+  EXPECT_EQ(4096u, cache_->bytes_saved());
+}
+
+TEST_F(SpeedreaderDistilledPageCacheTest, EvictsLeastRecentlyUsed) {
+  cache_->Put("a", std::string(400, 'a'));
+  cache_->Put("b", std::string(400, 'b'));
+  EXPECT_TRUE(Get("a"));
+  cache_->Put("c", std::string(400, 'c'));
+  EXPECT_TRUE(Get("a"));
+  EXPECT_FALSE(Get("b"));
+  EXPECT_TRUE(Get("c"));
+  EXPECT_EQ(800u, cache_->size_bytes());
+
+  // Entries larger than the whole cache are not stored.
+  cache_->Put("d", std::string(1001, 'd'));
+  EXPECT_FALSE(Get("d"));
+}
+
+TEST_F(SpeedreaderDistilledPageCacheTest, Clear) {
+  cache_->Put("key", "distilled");
+  cache_->Clear();
+  EXPECT_FALSE(Get("key"));
+  EXPECT_EQ(0u, cache_->size_bytes());
+}
+
+TEST_F(SpeedreaderDistilledPageCacheTest, ClearOnNewRewriterVersion) {
+  cache_->SetRewriterVersion("1");
+  cache_->Put("key", "distilled");
+  cache_->SetRewriterVersion("1");
+  EXPECT_TRUE(Get("key"));
+
+  cache_->SetRewriterVersion("2");
+  EXPECT_FALSE(Get("key"));
+  EXPECT_EQ(0u, cache_->size_bytes());
+}
+
+}  // namespace speedreader
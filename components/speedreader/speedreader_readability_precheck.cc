@@ -0,0 +1,203 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/speedreader/speedreader_readability_precheck.h"
+
+#include "base/strings/string_util.h"
+
+namespace speedreader {
+
+namespace {
+
+// Longer tags are truncated; this is enough for the attributes we look at.
+constexpr size_t kMaxTagLength = 512;
+
+// Paragraphs with at least this many non-whitespace characters outside links
+// count as article-like.
+constexpr size_t kLongParagraphChars = 80;
+constexpr size_t kMinLongParagraphs = 3;
+// Total paragraph text that makes a page readable even if the paragraphs are
+// short. Halved inside a <main> element. Pages with less text than this
+// outside links, paragraphs or not, are not readable.
+constexpr size_t kMinParagraphChars = 1500;
+
+const char kCommentEnd[] = "-->";
+const char kScriptEnd[] = "</script";
+const char kStyleEnd[] = "</style";
+
+// Elements that implicitly end an open <p>.
+const char* const kBlockTags[] = {
+    "p",   "div",   "article", "section", "main", "header", "footer",
+    "nav", "aside", "ul",      "ol",      "li",   "table",  "form",
+    "h1",  "h2",    "h3",      "h4",      "h5",   "h6",     "pre",
+    "dl",  "body",  "figure",  "hr",      "blockquote",
+};
+
+bool IsBlockTag(base::StringPiece name) {
+  for (const char* block_tag : kBlockTags) {
+    if (name == block_tag)
+      return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+SpeedreaderReadabilityPrecheck::SpeedreaderReadabilityPrecheck() = default;
+SpeedreaderReadabilityPrecheck::~SpeedreaderReadabilityPrecheck() = default;
+
+SpeedreaderReadabilityPrecheck::Result SpeedreaderReadabilityPrecheck::Feed(
+    base::StringPiece chunk) {
+  if (result_ != Result::kUndecided)
+    return result_;
+  Scan(chunk.substr(0, kReadabilityPrecheckBudget - bytes_seen_));
+  if (result_ == Result::kUndecided &&
+      bytes_seen_ >= kReadabilityPrecheckBudget) {
+    Decide(false);
+  }
+  return result_;
+}
+
+SpeedreaderReadabilityPrecheck::Result SpeedreaderReadabilityPrecheck::End() {
+  if (result_ == Result::kUndecided) {
+    OnParagraphEnd();
+    Decide(true);
+  }
+  return result_;
+}
+
+void SpeedreaderReadabilityPrecheck::Scan(base::StringPiece data) {
+  for (char c : data) {
+    ++bytes_seen_;
+    switch (mode_) {
+      case Mode::kText:
+        if (c == '<') {
+          mode_ = Mode::kTag;
+          tag_.clear();
+        } else if (!in_link_ && !base::IsAsciiWhitespace(c)) {
+          if (body_seen_)
+            ++body_text_chars_;
+          if (in_paragraph_) {
+            ++current_paragraph_chars_;
+            ++paragraph_chars_;
+          }
+        }
+        break;
+      case Mode::kTag:
+        if (c == '>') {
+          mode_ = Mode::kText;
+          OnTag();
+        } else if (tag_.size() < kMaxTagLength) {
+          tag_.push_back(base::ToLowerASCII(c));
+          if (tag_ == "!--") {
+            mode_ = Mode::kSkip;
+            end_marker_ = kCommentEnd;
+            end_marker_matched_ = 0;
+          }
+        }
+        break;
+      case Mode::kSkip:
+        c = base::ToLowerASCII(c);
+        if (c == end_marker_[end_marker_matched_]) {
+          if (end_marker_[++end_marker_matched_] != '\0')
+            break;
+          if (end_marker_ == kCommentEnd) {
+            mode_ = Mode::kText;
+          } else {
+            // Let the rest of the end tag be consumed as a tag.
+            mode_ = Mode::kTag;
+            tag_.assign(end_marker_ + 1);
+          }
+        } else if (end_marker_ != kCommentEnd || c != '-') {
+          end_marker_matched_ = c == end_marker_[0] ? 1 : 0;
+        }
+        // Otherwise a run of dashes keeps "--" matched.
+        break;
+    }
+    if (result_ != Result::kUndecided)
+      return;
+  }
+}
+
+void SpeedreaderReadabilityPrecheck::OnTag() {
+  const bool closing = !tag_.empty() && tag_[0] == '/';
+  base::StringPiece name(tag_);
+  if (closing)
+    name.remove_prefix(1);
+  name = name.substr(0, name.find_first_of(" \t\n\r\f/"));
+
+  if (IsBlockTag(name)) {
+    OnParagraphEnd();
+    // <body> may be omitted, but block elements only appear in it.
+    body_seen_ = true;
+  }
+
+  if (closing) {
+    if (name == "head")
+      body_seen_ = true;
+    if (name == "a")
+      in_link_ = false;
+    return;
+  }
+
+  if (name == "p") {
+    in_paragraph_ = true;
+  } else if (name == "a") {
+    in_link_ = true;
+  } else if (name == "main") {
+    has_main_ = true;
+  } else if (name == "article") {
+    has_article_marker_ = true;
+  } else if (name == "meta") {
+    if (tag_.find("og:type") != std::string::npos &&
+        tag_.find("article") != std::string::npos) {
+      has_article_marker_ = true;
+    }
+  } else if ((name == "script" || name == "style") &&
+             !base::EndsWith(tag_, "/", base::CompareCase::SENSITIVE)) {
+    mode_ = Mode::kSkip;
+    end_marker_ = name == "script" ? kScriptEnd : kStyleEnd;
+    end_marker_matched_ = 0;
+  }
+
+  if (!has_article_marker_ &&
+      (tag_.find("schema.org/article") != std::string::npos ||
+       tag_.find("schema.org/newsarticle") != std::string::npos ||
+       tag_.find("schema.org/blogposting") != std::string::npos ||
+       tag_.find("articlebody") != std::string::npos)) {
+    has_article_marker_ = true;
+  }
+
+  Decide(false);
+}
+
+void SpeedreaderReadabilityPrecheck::OnParagraphEnd() {
+  if (in_paragraph_ && current_paragraph_chars_ >= kLongParagraphChars)
+    ++long_paragraphs_;
+  in_paragraph_ = false;
+  current_paragraph_chars_ = 0;
+}
+
+void SpeedreaderReadabilityPrecheck::Decide(bool at_end) {
+  const size_t min_paragraph_chars =
+      has_main_ ? kMinParagraphChars / 2 : kMinParagraphChars;
+  if (has_article_marker_ || long_paragraphs_ >= kMinLongParagraphs ||
+      paragraph_chars_ >= min_paragraph_chars) {
+    result_ = Result::kReadable;
+  } else if (at_end) {
+    // The text may still be an article laid out without <p> elements.
+    result_ = body_text_chars_ < kMinParagraphChars ? Result::kNotReadable
+                                                    : Result::kInconclusive;
+  } else if (bytes_seen_ >= kReadabilityPrecheckBudget) {
+    // Don't hold the page back any longer. Without article evidence in the
+    // part of the body seen so far, pass it through; text that may still be
+    // an article, or a head that hasn't ended yet, is left to the rewriter.
+    result_ = body_seen_ && body_text_chars_ < kMinParagraphChars
+                  ? Result::kNotReadable
+                  : Result::kInconclusive;
+  }
+}
+
+}  // namespace speedreader
@@ -0,0 +1,96 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_READABILITY_PRECHECK_H_
+#define BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_READABILITY_PRECHECK_H_
+
+#include <string>
+
+#include "base/strings/string_piece.h"
+
+namespace speedreader {
+
+// The pre-check decides on at most this many bytes of the response body.
+constexpr size_t kReadabilityPrecheckBudget = 64 * 1024;
+
+// Cheap streaming classifier that looks at the beginning of an HTML document
+// and guesses whether it is an article before any rewriting is done. It only
+// tokenizes tags and counts text, so pages that are clearly not articles
+// (search results, app shells, forms, link lists) can be passed through
+// without waiting for the rewriter.
+//
+// A decision is always made within kReadabilityPrecheckBudget bytes. A page is
+// ruled out when the body seen so far has little text outside links and no
+// article markers or paragraph text. Article markup without <p> elements is
+// common, so a body with enough other text is inconclusive and left to the
+// rewriter, as is a page whose head doesn't end within the budget. Articles
+// behind more than the budget of navigation links are ruled out too; that is
+// the price of not buffering the page.
+class SpeedreaderReadabilityPrecheck {
+ public:
+  enum class Result {
+    kUndecided,
+    kReadable,
+    // Not enough evidence either way; fall back to full distillation.
+    kInconclusive,
+    kNotReadable,
+  };
+
+  SpeedreaderReadabilityPrecheck();
+  ~SpeedreaderReadabilityPrecheck();
+
+  SpeedreaderReadabilityPrecheck(const SpeedreaderReadabilityPrecheck&) =
+      delete;
+  SpeedreaderReadabilityPrecheck& operator=(
+      const SpeedreaderReadabilityPrecheck&) = delete;
+
+  // Scans the next chunk of the body. Once a decision is made it sticks and
+  // further chunks are ignored.
+  Result Feed(base::StringPiece chunk);
+
+  // Signals the end of the body and forces a decision.
+  Result End();
+
+  Result result() const { return result_; }
+  // Number of bytes scanned before the decision was made.
+  size_t bytes_seen() const { return bytes_seen_; }
+
+ private:
+  enum class Mode {
+    kText,
+    kTag,
+    // Inside a comment or a <script>/<style> element, until |end_marker_|.
+    kSkip,
+  };
+
+  void Scan(base::StringPiece data);
+  void OnTag();
+  void OnParagraphEnd();
+  void Decide(bool at_end);
+
+  Result result_ = Result::kUndecided;
+  size_t bytes_seen_ = 0;
+
+  Mode mode_ = Mode::kText;
+  // Lower-cased tag contents between '<' and '>', truncated.
+  std::string tag_;
+  const char* end_marker_ = nullptr;
+  size_t end_marker_matched_ = 0;
+
+  bool body_seen_ = false;
+  bool has_article_marker_ = false;
+  bool has_main_ = false;
+  bool in_paragraph_ = false;
+  bool in_link_ = false;
+  size_t current_paragraph_chars_ = 0;
+  size_t paragraph_chars_ = 0;
+  // Text in the body outside links, whether or not it is in a paragraph.
+  size_t body_text_chars_ = 0;
+  size_t long_paragraphs_ = 0;
+};
+
+}  // namespace speedreader
+
+#endif  // BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_READABILITY_PRECHECK_H_
@@ -0,0 +1,199 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/speedreader/speedreader_readability_precheck.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/files/file_enumerator.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/path_service.h"
+#include "base/timer/elapsed_timer.h"
+#include "brave/common/brave_paths.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace speedreader {
+
+namespace {
+
+using Result = SpeedreaderReadabilityPrecheck::Result;
+
+// Network-sized chunks.
+constexpr size_t kChunkSize = 4096;
+
+struct CorpusPage {
+  base::FilePath path;
+  std::string html;
+  bool readable;
+};
+
+std::vector<CorpusPage> LoadCorpus() {
+  base::FilePath corpus_dir;
+  base::PathService::Get(brave::DIR_TEST_DATA, &corpus_dir);
+  corpus_dir = corpus_dir.AppendASCII("speedreader").AppendASCII("precheck");
+
+  std::vector<CorpusPage> corpus;
+  for (const bool readable : {true, false}) {
+    base::FileEnumerator enumerator(
+        corpus_dir.AppendASCII(readable ? "readable" : "not_readable"), false,
+        base::FileEnumerator::FILES, FILE_PATH_LITERAL("*.html"));
+    for (base::FilePath path = enumerator.Next(); !path.empty();
+         path = enumerator.Next()) {
+      CorpusPage page{path, std::string(), readable};
+      EXPECT_TRUE(base::ReadFileToString(path, &page.html));
+      corpus.push_back(std::move(page));
+    }
+  }
+  return corpus;
+}
+
+// Feeds |html| in |chunk_size| pieces, stopping as soon as a decision is made,
+// like SpeedreaderBodyDistiller does.
+Result Classify(const std::string& html,
+                size_t chunk_size,
+                size_t* bytes_seen = nullptr) {
+  SpeedreaderReadabilityPrecheck precheck;
+  base::StringPiece remaining(html);
+  while (!remaining.empty() && precheck.result() == Result::kUndecided) {
+    precheck.Feed(remaining.substr(0, chunk_size));
+    remaining.remove_prefix(std::min(chunk_size, remaining.size()));
+  }
+  const Result result = precheck.End();
+  if (bytes_seen)
+    *bytes_seen = precheck.bytes_seen();
+  return result;
+}
+
+}  // namespace
+
+TEST(SpeedreaderReadabilityPrecheckTest, CorpusNeverRulesOutArticles) {
+  const std::vector<CorpusPage> corpus = LoadCorpus();
+  ASSERT_FALSE(corpus.empty());
+
+  size_t ruled_out = 0;
+  for (const auto& page : corpus) {
+    const Result result = Classify(page.html, kChunkSize);
+    EXPECT_NE(Result::kUndecided, result) << page.path;
+    // Ruling an article out skips distillation, so it must never happen.
+    // Anything else only costs a rewriter run.
+    if (page.readable)
+      EXPECT_NE(Result::kNotReadable, result) << page.path;
+    else if (result == Result::kNotReadable)
+      ruled_out++;
+  }
+
+  // The pre-check only pays off if it rules some pages out.
+  EXPECT_GT(ruled_out, 0u);
+}
+
+TEST(SpeedreaderReadabilityPrecheckTest, CorpusAddedLatency) {
+  const std::vector<CorpusPage> corpus = LoadCorpus();
+  ASSERT_FALSE(corpus.empty());
+
+  for (const auto& page : corpus) {
+    // The decision, and with it pass-through of pages that are ruled out, is
+    // held back for at most the pre-check budget.
+    SpeedreaderReadabilityPrecheck precheck;
+    if (precheck.Feed(page.html) == Result::kUndecided) {
+      // Small pages are decided at the end of the body.
+      EXPECT_LT(page.html.size(), kReadabilityPrecheckBudget) << page.path;
+      precheck.End();
+    }
+    const size_t bytes_seen = precheck.bytes_seen();
+    EXPECT_LE(bytes_seen, kReadabilityPrecheckBudget) << page.path;
+
+    constexpr int kIterations = 100;
+    base::ElapsedTimer timer;
+    for (int i = 0; i < kIterations; ++i)
+      Classify(page.html, kChunkSize);
+    LOG(INFO) << page.path.BaseName() << ": decided after " << bytes_seen
+              << " bytes in "
+              << timer.Elapsed().InMicrosecondsF() / kIterations << "us";
+  }
+}
+
+TEST(SpeedreaderReadabilityPrecheckTest, ChunkingDoesNotChangeResult) {
+  for (const auto& page : LoadCorpus()) {
+    const Result whole = Classify(page.html, page.html.size());
+    EXPECT_EQ(whole, Classify(page.html, kChunkSize)) << page.path;
+    EXPECT_EQ(whole, Classify(page.html, 7)) << page.path;
+    EXPECT_EQ(whole, Classify(page.html, 1)) << page.path;
+  }
+}
+
+TEST(SpeedreaderReadabilityPrecheckTest, IgnoresScriptsAndComments) {
+  const std::string paragraph = "<p>" + std::string(200, 'x') + "</p>";
+  std::string html = "<html><body><script>var s = '";
+  for (int i = 0; i < 3; ++i)
+    html += paragraph;
+  html += "';</script><!-- ";
+  for (int i = 0; i < 3; ++i)
+    html += paragraph;
+  html += " --></body></html>";
+  EXPECT_EQ(Result::kNotReadable, Classify(html, html.size()));
+
+  html += paragraph + paragraph + paragraph;
+  EXPECT_EQ(Result::kReadable, Classify(html, html.size()));
+}
+
+TEST(SpeedreaderReadabilityPrecheckTest, LargeHeadIsLeftToRewriter) {
+  std::string html = "<html><head><style>";
+  html += std::string(kReadabilityPrecheckBudget, ' ');
+  html += "</style></head><body></body></html>";
+
+  SpeedreaderReadabilityPrecheck precheck;
+  EXPECT_EQ(Result::kInconclusive, precheck.Feed(html));
+  EXPECT_EQ(kReadabilityPrecheckBudget, precheck.bytes_seen());
+}
+
+TEST(SpeedreaderReadabilityPrecheckTest, LinkListIsRuledOutAtBudget) {
+  std::string html = "<html><body><ul>";
+  while (html.size() < 2 * kReadabilityPrecheckBudget)
+    html += "<li><a href=\"/item\">Item</a></li>";
+  html += "</ul></body></html>";
+
+  SpeedreaderReadabilityPrecheck precheck;
+  EXPECT_EQ(Result::kNotReadable, precheck.Feed(html));
+  EXPECT_EQ(kReadabilityPrecheckBudget, precheck.bytes_seen());
+}
+
+TEST(SpeedreaderReadabilityPrecheckTest, ArticleBehindBudgetIsRuledOut) {
+  // An article that only starts after more than the budget of navigation
+  // links is not seen by the pre-check.
+  base::FilePath path;
+  base::PathService::Get(brave::DIR_TEST_DATA, &path);
+  path = path.AppendASCII("speedreader")
+             .AppendASCII("precheck")
+             .AppendASCII("article_behind_long_menu.html");
+  std::string html;
+  ASSERT_TRUE(base::ReadFileToString(path, &html));
+  ASSERT_GT(html.size(), kReadabilityPrecheckBudget);
+
+  size_t bytes_seen = 0;
+  EXPECT_EQ(Result::kNotReadable, Classify(html, kChunkSize, &bytes_seen));
+  EXPECT_EQ(kReadabilityPrecheckBudget, bytes_seen);
+}
+
+TEST(SpeedreaderReadabilityPrecheckTest, DivOnlyTextIsLeftToRewriter) {
+  std::string text;
+  for (int i = 0; i < 20; ++i)
+    text += std::string(100, 'x') + " <br>";
+
+  // Article text laid out in <div>s, with or without a <body> tag.
+  std::string html = "<html><body><div class=\"story\">" + text +
+                     "</div></body></html>";
+  EXPECT_EQ(Result::kInconclusive, Classify(html, html.size()));
+  html = "<html><head></head>" + text + "</html>";
+  EXPECT_EQ(Result::kInconclusive, Classify(html, html.size()));
+
+  // Text in links doesn't count.
+  html = "<html><body><div><a href=\"/\">" + text + "</a></div></body></html>";
+  EXPECT_EQ(Result::kNotReadable, Classify(html, html.size()));
+}
+
+}  // namespace speedreader
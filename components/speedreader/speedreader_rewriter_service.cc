@@ -9,7 +9,9 @@
 
 #include "base/bind.h"
 #include "base/files/file_util.h"
+#include "base/hash/hash.h"
 #include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/task/post_task.h"
 #include "brave/components/speedreader/rust/ffi/speedreader.h"
 #include "brave/components/speedreader/speedreader_component.h"
@@ -46,6 +48,8 @@ SpeedreaderRewriterService::SpeedreaderRewriterService(
       ui::ResourceBundle::GetSharedInstance().LoadDataResourceString(
           IDR_SPEEDREADER_STYLE_DESKTOP) +
       "</style>";
+  stylesheet_version_ =
+      base::NumberToString(base::PersistentHash(content_stylesheet_));
 
   // Check the paths from the component as observer may register
   // later than the paths were available in the component.
@@ -71,8 +75,10 @@ void SpeedreaderRewriterService::OnWhitelistReady(const base::FilePath& path) {
       base::BindOnce(
           &brave_component_updater::LoadDATFileData<speedreader::SpeedReader>,
           path),
+      // The component install directory is versioned, so the path identifies
+      // the whitelist.
       base::BindOnce(&SpeedreaderRewriterService::OnLoadDATFileData,
-                     weak_factory_.GetWeakPtr()));
+                     weak_factory_.GetWeakPtr(), path.AsUTF8Unsafe()));
 }
 
 void SpeedreaderRewriterService::OnStylesheetReady(const base::FilePath& path) {
@@ -92,20 +98,38 @@ std::unique_ptr<Rewriter> SpeedreaderRewriterService::MakeRewriter(
   return speedreader_->MakeRewriter(url.spec());
 }
 
+std::unique_ptr<Rewriter> SpeedreaderRewriterService::MakeRewriter(
+    const GURL& url,
+    void (*output_sink)(const char*, size_t, void*),
+    void* output_sink_user_data) {
+  return speedreader_->MakeRewriter(url.spec(), RewriterType::RewriterUnknown,
+                                    output_sink, output_sink_user_data);
+}
+
 const std::string& SpeedreaderRewriterService::GetContentStylesheet() {
   return content_stylesheet_;
 }
 
+std::string SpeedreaderRewriterService::GetRewriterVersion() {
+  return whitelist_version_ + ":" + stylesheet_version_;
+}
+
 void SpeedreaderRewriterService::OnLoadStylesheet(std::string stylesheet) {
   VLOG(2) << "Speedreader stylesheet loaded";
   content_stylesheet_ = stylesheet;
+  stylesheet_version_ =
+      base::NumberToString(base::PersistentHash(content_stylesheet_));
 }
 
 void SpeedreaderRewriterService::OnLoadDATFileData(
+    const std::string& whitelist_version,
     GetDATFileDataResult result) {
   VLOG(2) << "Speedreader loaded from DAT file";
-  if (result.first)
-    speedreader_ = std::move(result.first);
+  if (!result.first)
+    return;
+  // The version only changes together with the rewriter it identifies.
+  speedreader_ = std::move(result.first);
+  whitelist_version_ = whitelist_version;
 }
 
 }  // namespace speedreader
@@ -44,16 +44,28 @@ class SpeedreaderRewriterService : public SpeedreaderComponent::Observer {
   // The API
   bool IsWhitelisted(const GURL& url);
   std::unique_ptr<Rewriter> MakeRewriter(const GURL& url);
+  // Makes a rewriter that hands every new chunk of output to |output_sink|
+  // instead of accumulating it.
+  std::unique_ptr<Rewriter> MakeRewriter(
+      const GURL& url,
+      void (*output_sink)(const char*, size_t, void*),
+      void* output_sink_user_data);
   const std::string& GetContentStylesheet();
+  // Identifies the whitelist/rewriter and stylesheet currently in use, so that
+  // cached output of older versions is never served.
+  std::string GetRewriterVersion();
 
  private:
   using GetDATFileDataResult =
       brave_component_updater::LoadDATFileDataResult<speedreader::SpeedReader>;
 
-  void OnLoadDATFileData(GetDATFileDataResult result);
+  void OnLoadDATFileData(const std::string& whitelist_version,
+                         GetDATFileDataResult result);
   void OnLoadStylesheet(std::string stylesheet);
 
   std::string content_stylesheet_;
+  std::string whitelist_version_;
+  std::string stylesheet_version_;
   std::unique_ptr<speedreader::SpeedreaderComponent> component_;
   std::unique_ptr<speedreader::SpeedReader> speedreader_;
   base::WeakPtrFactory<SpeedreaderRewriterService> weak_factory_{this};
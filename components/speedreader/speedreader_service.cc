@@ -6,8 +6,10 @@
 #include "brave/components/speedreader/speedreader_service.h"
 
 #include "base/feature_list.h"
+#include "base/files/file_path.h"
 #include "base/metrics/histogram_macros.h"
 #include "brave/components/speedreader/features.h"
+#include "brave/components/speedreader/speedreader_distilled_page_cache.h"
 #include "brave/components/speedreader/speedreader_pref_names.h"
 #include "brave/components/weekly_storage/weekly_storage.h"
 #include "components/prefs/pref_registry_simple.h"
@@ -17,6 +19,8 @@ namespace speedreader {
 
 namespace {
 
+constexpr size_t kDistilledPageCacheMaxSize = 50 * 1024 * 1024;
+
 // Note: append-only array! Never remove any existing values, as this array
 // is used to bucket a UMA histogram, and removing values breaks that.
 constexpr std::array<uint64_t, 5> kSpeedReaderToggleBuckets{
@@ -74,7 +78,15 @@ void RecordHistograms(PrefService* prefs, bool toggled, bool enabled_now) {
 
 }  // namespace
 
-SpeedreaderService::SpeedreaderService(PrefService* prefs) : prefs_(prefs) {}
+SpeedreaderService::SpeedreaderService(
+    PrefService* prefs,
+    const base::FilePath& distilled_page_cache_dir)
+    : prefs_(prefs) {
+  if (!distilled_page_cache_dir.empty()) {
+    distilled_page_cache_ = std::make_unique<SpeedreaderDistilledPageCache>(
+        distilled_page_cache_dir, kDistilledPageCacheMaxSize);
+  }
+}
 
 SpeedreaderService::~SpeedreaderService() {}
 
@@ -10,14 +10,22 @@
 
 #include "components/keyed_service/core/keyed_service.h"
 
+namespace base {
+class FilePath;
+}  // namespace base
+
 class PrefRegistrySimple;
 class PrefService;
 
 namespace speedreader {
 
+class SpeedreaderDistilledPageCache;
+
 class SpeedreaderService : public KeyedService {
  public:
-  explicit SpeedreaderService(PrefService* prefs);
+  // An empty |distilled_page_cache_dir| disables the distilled page cache.
+  SpeedreaderService(PrefService* prefs,
+                     const base::FilePath& distilled_page_cache_dir);
   ~SpeedreaderService() override;
 
   static void RegisterPrefs(PrefRegistrySimple* registry);
@@ -25,11 +33,17 @@ class SpeedreaderService : public KeyedService {
   void ToggleSpeedreader();
   bool IsEnabled();
 
+  // May be null.
+  SpeedreaderDistilledPageCache* distilled_page_cache() {
+    return distilled_page_cache_.get();
+  }
+
   SpeedreaderService(const SpeedreaderService&) = delete;
   SpeedreaderService& operator=(const SpeedreaderService&) = delete;
 
  private:
   PrefService* prefs_ = nullptr;
+  std::unique_ptr<SpeedreaderDistilledPageCache> distilled_page_cache_;
 };
 
 }  // namespace speedreader
@@ -5,24 +5,58 @@
 
 #include "brave/components/speedreader/speedreader_throttle.h"
 
+#include <string>
 #include <utility>
 
+#include "base/bind.h"
+#include "brave/components/speedreader/speedreader_distilled_page_cache.h"
 #include "brave/components/speedreader/speedreader_rewriter_service.h"
 #include "brave/components/speedreader/speedreader_url_loader.h"
 #include "mojo/public/cpp/bindings/pending_receiver.h"
 #include "mojo/public/cpp/bindings/pending_remote.h"
+#include "net/cookies/cookie_options.h"
+#include "net/http/http_request_headers.h"
+#include "services/network/public/cpp/resource_request.h"
+#include "services/network/public/mojom/cookie_manager.mojom.h"
 #include "services/network/public/mojom/url_response_head.mojom.h"
 
 namespace speedreader {
 
 SpeedReaderThrottle::SpeedReaderThrottle(
     SpeedreaderRewriterService* rewriter_service,
+    SpeedreaderDistilledPageCache* distilled_page_cache,
+    network::mojom::CookieManager* cookie_manager,
     scoped_refptr<base::SingleThreadTaskRunner> task_runner)
     : rewriter_service_(rewriter_service),
+      distilled_page_cache_(distilled_page_cache),
+      cookie_manager_(cookie_manager),
       task_runner_(std::move(task_runner)) {}
 
 SpeedReaderThrottle::~SpeedReaderThrottle() = default;
 
+void SpeedReaderThrottle::WillStartRequest(network::ResourceRequest* request,
+                                           bool* defer) {
+  if (!distilled_page_cache_ || !cookie_manager_)
+    return;
+  request_url_ = request->url;
+  if (request->headers.HasHeader(net::HttpRequestHeaders::kAuthorization) ||
+      request->headers.HasHeader(net::HttpRequestHeaders::kCookie)) {
+    return;
+  }
+  // The lookup is not waited for; if it hasn't completed by the time the
+  // response arrives, the response is simply not cached.
+  cookie_manager_->GetCookieList(
+      request_url_, net::CookieOptions::MakeAllInclusive(),
+      base::BindOnce(&SpeedReaderThrottle::OnGetCookieList,
+                     weak_factory_.GetWeakPtr()));
+}
+
+void SpeedReaderThrottle::OnGetCookieList(
+    const net::CookieAccessResultList& cookies,
+    const net::CookieAccessResultList& excluded_cookies) {
+  has_credentials_ = !cookies.empty();
+}
+
 void SpeedReaderThrottle::WillProcessResponse(
     const GURL& response_url,
     network::mojom::URLResponseHead* response_head,
@@ -36,10 +70,23 @@ void SpeedReaderThrottle::WillProcessResponse(
   mojo::PendingRemote<network::mojom::URLLoader> source_loader;
   mojo::PendingReceiver<network::mojom::URLLoaderClient> source_client_receiver;
   SpeedReaderURLLoader* speedreader_loader;
+  std::string distilled_page_cache_key;
+  // Redirected requests are not cached, as only the credentials sent to the
+  // original URL are known.
+  if (distilled_page_cache_ && !has_credentials_ &&
+      response_url == request_url_) {
+    const std::string rewriter_version =
+        rewriter_service_->GetRewriterVersion();
+    distilled_page_cache_->SetRewriterVersion(rewriter_version);
+    distilled_page_cache_key = SpeedreaderDistilledPageCache::GetKey(
+        response_url, response_head->headers.get(), rewriter_version);
+  }
   std::tie(new_remote, new_receiver, speedreader_loader) =
-      SpeedReaderURLLoader::CreateLoader(weak_factory_.GetWeakPtr(),
-                                         response_url, task_runner_,
-                                         rewriter_service_);
+      SpeedReaderURLLoader::CreateLoader(
+          weak_factory_.GetWeakPtr(), response_url, task_runner_,
+          rewriter_service_,
+          distilled_page_cache_key.empty() ? nullptr : distilled_page_cache_,
+          distilled_page_cache_key);
   delegate_->InterceptResponse(std::move(new_remote), std::move(new_receiver),
                                &source_loader, &source_client_receiver);
   speedreader_loader->Start(std::move(source_loader),
@@ -7,11 +7,20 @@
 #define BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_THROTTLE_H_
 
 #include "base/memory/weak_ptr.h"
+#include "net/cookies/canonical_cookie.h"
 #include "services/network/public/mojom/url_response_head.mojom-forward.h"
 #include "third_party/blink/public/common/loader/url_loader_throttle.h"
+#include "url/gurl.h"
+
+namespace network {
+namespace mojom {
+class CookieManager;
+}  // namespace mojom
+}  // namespace network
 
 namespace speedreader {
 
+class SpeedreaderDistilledPageCache;
 class SpeedreaderRewriterService;
 
 // Launches the speedreader distillation pass over a reponce body, deferring
@@ -24,8 +33,12 @@ class SpeedReaderThrottle : public blink::URLLoaderThrottle {
  public:
   // |task_runner| is used to bind the right task runner for handling incoming
   // IPC in SpeedReaderLoader. |task_runner| is supposed to be bound to the
-  // current sequence.
+  // current sequence. |distilled_page_cache| may be null to disable caching.
+  // |cookie_manager| is used to find out whether the request carries cookies,
+  // as responses to credentialed requests are never cached.
   SpeedReaderThrottle(SpeedreaderRewriterService* rewriter_service,
+                      SpeedreaderDistilledPageCache* distilled_page_cache,
+                      network::mojom::CookieManager* cookie_manager,
                       scoped_refptr<base::SingleThreadTaskRunner> task_runner);
   ~SpeedReaderThrottle() override;
 
@@ -33,6 +46,8 @@ class SpeedReaderThrottle : public blink::URLLoaderThrottle {
   SpeedReaderThrottle& operator=(const SpeedReaderThrottle&) = delete;
 
   // Implements blink::URLLoaderThrottle.
+  void WillStartRequest(network::ResourceRequest* request,
+                        bool* defer) override;
   void WillProcessResponse(const GURL& response_url,
                            network::mojom::URLResponseHead* response_head,
                            bool* defer) override;
@@ -41,7 +56,16 @@ class SpeedReaderThrottle : public blink::URLLoaderThrottle {
   void Resume();
 
  private:
+  void OnGetCookieList(const net::CookieAccessResultList& cookies,
+                       const net::CookieAccessResultList& excluded_cookies);
+
   SpeedreaderRewriterService* rewriter_service_;  // not owned
+  SpeedreaderDistilledPageCache* distilled_page_cache_;  // not owned
+  network::mojom::CookieManager* cookie_manager_;  // not owned
+  // The request URL and whether the request carries credentials. Treated as
+  // credentialed until the cookie lookup says otherwise.
+  GURL request_url_;
+  bool has_credentials_ = true;
   scoped_refptr<base::SingleThreadTaskRunner> task_runner_;
   base::WeakPtrFactory<SpeedReaderThrottle> weak_factory_{this};
 };
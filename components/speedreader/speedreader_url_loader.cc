@@ -10,9 +10,14 @@
 #include <utility>
 
 #include "base/bind.h"
+#include "base/feature_list.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/task/post_task.h"
+#include "brave/components/speedreader/features.h"
 #include "brave/components/speedreader/rust/ffi/speedreader.h"
+#include "brave/components/speedreader/speedreader_body_distiller.h"
+#include "brave/components/speedreader/speedreader_distilled_page_cache.h"
+#include "brave/components/speedreader/speedreader_readability_precheck.h"
 #include "brave/components/speedreader/speedreader_rewriter_service.h"
 #include "brave/components/speedreader/speedreader_throttle.h"
 #include "mojo/public/cpp/bindings/self_owned_receiver.h"
@@ -34,7 +39,9 @@ SpeedReaderURLLoader::CreateLoader(
     base::WeakPtr<SpeedReaderThrottle> throttle,
     const GURL& response_url,
     scoped_refptr<base::SingleThreadTaskRunner> task_runner,
-    SpeedreaderRewriterService* rewriter_service) {
+    SpeedreaderRewriterService* rewriter_service,
+    SpeedreaderDistilledPageCache* distilled_page_cache,
+    const std::string& distilled_page_cache_key) {
   mojo::PendingRemote<network::mojom::URLLoader> url_loader;
   mojo::PendingRemote<network::mojom::URLLoaderClient> url_loader_client;
   mojo::PendingReceiver<network::mojom::URLLoaderClient>
@@ -43,7 +50,8 @@ SpeedReaderURLLoader::CreateLoader(
 
   auto loader = base::WrapUnique(new SpeedReaderURLLoader(
       std::move(throttle), response_url, std::move(url_loader_client),
-      std::move(task_runner), rewriter_service));
+      std::move(task_runner), rewriter_service, distilled_page_cache,
+      distilled_page_cache_key));
   SpeedReaderURLLoader* loader_rawptr = loader.get();
   mojo::MakeSelfOwnedReceiver(std::move(loader),
                               url_loader.InitWithNewPipeAndPassReceiver());
@@ -57,7 +65,9 @@ SpeedReaderURLLoader::SpeedReaderURLLoader(
     mojo::PendingRemote<network::mojom::URLLoaderClient>
         destination_url_loader_client,
     scoped_refptr<base::SingleThreadTaskRunner> task_runner,
-    SpeedreaderRewriterService* rewriter_service)
+    SpeedreaderRewriterService* rewriter_service,
+    SpeedreaderDistilledPageCache* distilled_page_cache,
+    const std::string& distilled_page_cache_key)
     : throttle_(throttle),
       destination_url_loader_client_(std::move(destination_url_loader_client)),
       response_url_(response_url),
@@ -68,7 +78,9 @@ SpeedReaderURLLoader::SpeedReaderURLLoader(
       body_producer_watcher_(FROM_HERE,
                              mojo::SimpleWatcher::ArmingPolicy::MANUAL,
                              std::move(task_runner)),
-      rewriter_service_(rewriter_service) {}
+      rewriter_service_(rewriter_service),
+      distilled_page_cache_(distilled_page_cache),
+      distilled_page_cache_key_(distilled_page_cache_key) {}
 
 SpeedReaderURLLoader::~SpeedReaderURLLoader() = default;
 
@@ -79,6 +91,13 @@ void SpeedReaderURLLoader::Start(
   source_url_loader_.Bind(std::move(source_url_loader_remote));
   source_url_client_receiver_.Bind(std::move(source_url_client_receiver),
                                    task_runner_);
+  if (distilled_page_cache_) {
+    cache_lookup_pending_ = true;
+    distilled_page_cache_->Get(
+        distilled_page_cache_key_,
+        base::BindOnce(&SpeedReaderURLLoader::OnCacheLookup,
+                       weak_factory_.GetWeakPtr()));
+  }
 }
 
 void SpeedReaderURLLoader::OnReceiveResponse(
@@ -117,8 +136,26 @@ void SpeedReaderURLLoader::OnTransferSizeUpdated(int32_t transfer_size_diff) {
 void SpeedReaderURLLoader::OnStartLoadingResponseBody(
     mojo::ScopedDataPipeConsumerHandle body) {
   VLOG(2) << __func__ << " " << response_url_;
-  state_ = State::kLoading;
   body_consumer_handle_ = std::move(body);
+  if (cache_lookup_pending_) {
+    state_ = State::kWaitForCache;
+    return;
+  }
+  if (cached_body_) {
+    ServeFromCache();
+    return;
+  }
+  StartDistilling();
+}
+
+void SpeedReaderURLLoader::StartDistilling() {
+  if (base::FeatureList::IsEnabled(kSpeedreaderStreamingFeature)) {
+    StartStreaming();
+    if (state_ != State::kStreaming)
+      return;
+  } else {
+    state_ = State::kLoading;
+  }
   body_consumer_watcher_.Watch(
       body_consumer_handle_.get(),
       MOJO_HANDLE_SIGNAL_READABLE | MOJO_HANDLE_SIGNAL_PEER_CLOSED,
@@ -142,8 +179,10 @@ void SpeedReaderURLLoader::OnComplete(
       throttle_->Resume();
       destination_url_loader_client_->OnComplete(status);
       return;
+    case State::kWaitForCache:
     case State::kLoading:
     case State::kSending:
+    case State::kStreaming:
       // Defer calling OnComplete() until distilling has finished and all
       // data is sent.
       complete_status_ = status;
@@ -187,7 +226,72 @@ void SpeedReaderURLLoader::ResumeReadingBodyFromNet() {
   source_url_loader_->ResumeReadingBodyFromNet();
 }
 
+void SpeedReaderURLLoader::OnDataAvailable(const void* data,
+                                           size_t num_bytes) {
+  drained_bytes_ += num_bytes;
+}
+
+void SpeedReaderURLLoader::OnDataComplete() {
+  if (distilled_page_cache_)
+    distilled_page_cache_->RecordBytesSaved(drained_bytes_);
+}
+
+void SpeedReaderURLLoader::OnCacheLookup(
+    base::Optional<std::string> distilled) {
+  cache_lookup_pending_ = false;
+  if (state_ != State::kWaitForBody && state_ != State::kWaitForCache)
+    return;
+  if (distilled) {
+    VLOG(2) << __func__ << " cache hit for " << response_url_;
+    cached_body_ = std::move(distilled);
+  }
+  if (state_ == State::kWaitForBody)
+    return;
+  if (cached_body_) {
+    ServeFromCache();
+  } else {
+    StartDistilling();
+  }
+}
+
+void SpeedReaderURLLoader::ServeFromCache() {
+  DCHECK(cached_body_);
+  // The original body is not needed, but it is read to the end so that the
+  // source loader completes normally.
+  body_drainer_ = std::make_unique<mojo::DataPipeDrainer>(
+      this, std::move(body_consumer_handle_));
+  state_ = State::kLoading;
+  std::string body = std::move(*cached_body_);
+  cached_body_.reset();
+  CompleteLoading(std::move(body));
+}
+
 void SpeedReaderURLLoader::OnBodyReadable(MojoResult) {
+  if (state_ == State::kStreaming) {
+    std::string chunk(kReadBufferSize, '\0');
+    uint32_t read_bytes = kReadBufferSize;
+    MojoResult result = body_consumer_handle_->ReadData(
+        &chunk[0], &read_bytes, MOJO_READ_DATA_FLAG_NONE);
+    switch (result) {
+      case MOJO_RESULT_OK:
+        chunk.resize(read_bytes);
+        distiller_->Write(std::move(chunk));
+        body_consumer_watcher_.ArmOrNotify();
+        return;
+      case MOJO_RESULT_FAILED_PRECONDITION:
+        // Reading is finished.
+        body_consumer_watcher_.Cancel();
+        distiller_->End();
+        return;
+      case MOJO_RESULT_SHOULD_WAIT:
+        body_consumer_watcher_.ArmOrNotify();
+        return;
+      default:
+        NOTREACHED();
+        return;
+    }
+  }
+
   DCHECK_EQ(State::kLoading, state_);
 
   size_t start_size = buffered_body_.size();
@@ -213,21 +317,17 @@ void SpeedReaderURLLoader::OnBodyReadable(MojoResult) {
 
   DCHECK_EQ(MOJO_RESULT_OK, result);
   buffered_body_.resize(start_size + read_bytes);
-  // TODO(iefremov): We actually can partially |pumpContent| to speedreader,
-  // but skipping it for now to simplify things. Pumping is not free in terms
-  // of CPU ticks, so we will have to keep alive speedreader instance on another
-  // thread.
-
   body_consumer_watcher_.ArmOrNotify();
 }
 
 void SpeedReaderURLLoader::OnBodyWritable(MojoResult r) {
-  DCHECK_EQ(State::kSending, state_);
+  DCHECK(state_ == State::kSending || state_ == State::kStreaming);
   if (bytes_remaining_in_buffer_ > 0) {
     SendReceivedBodyToClient();
-  } else {
+  } else if (state_ == State::kSending || distiller_complete_) {
     CompleteSending();
   }
+  // Otherwise wait for more output from the distiller.
 }
 
 void SpeedReaderURLLoader::MaybeLaunchSpeedreader() {
@@ -240,6 +340,18 @@ void SpeedReaderURLLoader::MaybeLaunchSpeedreader() {
   VLOG(2) << __func__ << " buffered body size = " << buffered_body_.size();
   bytes_remaining_in_buffer_ = buffered_body_.size();
 
+  if (bytes_remaining_in_buffer_ > 0 &&
+      base::FeatureList::IsEnabled(kSpeedreaderReadabilityPrecheckFeature)) {
+    SpeedreaderReadabilityPrecheck precheck;
+    precheck.Feed(buffered_body_);
+    if (precheck.End() ==
+        SpeedreaderReadabilityPrecheck::Result::kNotReadable) {
+      VLOG(2) << __func__ << " not readable, skipping the rewriter";
+      CompleteLoading(std::move(buffered_body_));
+      return;
+    }
+  }
+
   if (bytes_remaining_in_buffer_ > 0) {
     // Offload heavy distilling to another thread.
     base::PostTaskAndReplyWithResult(
@@ -251,31 +363,34 @@ void SpeedReaderURLLoader::MaybeLaunchSpeedreader() {
               int written = rewriter->Write(data.c_str(), data.length());
               // Error occurred
               if (written != 0) {
-                return data;
+                return std::make_pair(std::move(data), false);
               }
 
               rewriter->End();
               const std::string& transformed = rewriter->GetOutput();
 
-              // TODO(brave-browser/issues/10372): would be better to pass
-              // explicit signal back from rewriter to indicate if content was
-              // found
-              if (transformed.length() < 1024) {
-                return data;
+              if (transformed.length() < kMinDistilledOutputSize) {
+                return std::make_pair(std::move(data), false);
               }
 
-              return stylesheet + transformed;
+              return std::make_pair(stylesheet + transformed, true);
             },
             std::move(buffered_body_),
             rewriter_service_->MakeRewriter(response_url_),
             rewriter_service_->GetContentStylesheet()),
-        base::BindOnce(&SpeedReaderURLLoader::CompleteLoading,
+        base::BindOnce(&SpeedReaderURLLoader::OnDistilled,
                        weak_factory_.GetWeakPtr()));
     return;
   }
   CompleteLoading(std::move(buffered_body_));
 }
 
+void SpeedReaderURLLoader::OnDistilled(std::pair<std::string, bool> result) {
+  if (result.second && distilled_page_cache_)
+    distilled_page_cache_->Put(distilled_page_cache_key_, result.first);
+  CompleteLoading(std::move(result.first));
+}
+
 void SpeedReaderURLLoader::CompleteLoading(std::string body) {
   DCHECK_EQ(State::kLoading, state_);
   state_ = State::kSending;
@@ -316,8 +431,70 @@ void SpeedReaderURLLoader::CompleteLoading(std::string body) {
   CompleteSending();
 }
 
+void SpeedReaderURLLoader::StartStreaming() {
+  if (!throttle_ || !rewriter_service_) {
+    Abort();
+    return;
+  }
+  state_ = State::kStreaming;
+  distiller_ = std::make_unique<SpeedreaderBodyDistiller>(
+      response_url_, rewriter_service_,
+      base::BindRepeating(&SpeedReaderURLLoader::OnDistillerOutput,
+                          weak_factory_.GetWeakPtr()),
+      base::BindOnce(&SpeedReaderURLLoader::OnDistillerComplete,
+                     weak_factory_.GetWeakPtr()));
+
+  throttle_->Resume();
+  mojo::ScopedDataPipeConsumerHandle body_to_send;
+  MojoResult result =
+      mojo::CreateDataPipe(nullptr, &body_producer_handle_, &body_to_send);
+  if (result != MOJO_RESULT_OK) {
+    Abort();
+    return;
+  }
+  body_producer_watcher_.Watch(
+      body_producer_handle_.get(),
+      MOJO_HANDLE_SIGNAL_WRITABLE | MOJO_HANDLE_SIGNAL_PEER_CLOSED,
+      base::BindRepeating(&SpeedReaderURLLoader::OnBodyWritable,
+                          base::Unretained(this)));
+  destination_url_loader_client_->OnStartLoadingResponseBody(
+      std::move(body_to_send));
+}
+
+void SpeedReaderURLLoader::OnDistillerOutput(std::string data) {
+  if (state_ != State::kStreaming)
+    return;
+  if (distilled_page_cache_)
+    streamed_output_.append(data);
+  const bool write_pending = bytes_remaining_in_buffer_ > 0;
+  if (write_pending) {
+    // Drop what has already been sent and queue the new data behind the rest.
+    buffered_body_.erase(0, buffered_body_.size() - bytes_remaining_in_buffer_);
+    buffered_body_.append(data);
+  } else {
+    buffered_body_ = std::move(data);
+  }
+  bytes_remaining_in_buffer_ = buffered_body_.size();
+  // A pending write will pick up the new data from OnBodyWritable().
+  if (!write_pending)
+    SendReceivedBodyToClient();
+}
+
+void SpeedReaderURLLoader::OnDistillerComplete(bool distilled) {
+  if (state_ != State::kStreaming)
+    return;
+  distiller_complete_ = true;
+  if (distilled && distilled_page_cache_) {
+    distilled_page_cache_->Put(distilled_page_cache_key_,
+                               std::move(streamed_output_));
+  }
+  streamed_output_.clear();
+  if (bytes_remaining_in_buffer_ == 0)
+    CompleteSending();
+}
+
 void SpeedReaderURLLoader::CompleteSending() {
-  DCHECK_EQ(State::kSending, state_);
+  DCHECK(state_ == State::kSending || state_ == State::kStreaming);
   state_ = State::kCompleted;
   // Call client's OnComplete() if |this|'s OnComplete() has already been
   // called.
@@ -328,10 +505,11 @@ void SpeedReaderURLLoader::CompleteSending() {
   body_producer_watcher_.Cancel();
   body_consumer_handle_.reset();
   body_producer_handle_.reset();
+  distiller_.reset();
 }
 
 void SpeedReaderURLLoader::SendReceivedBodyToClient() {
-  DCHECK_EQ(State::kSending, state_);
+  DCHECK(state_ == State::kSending || state_ == State::kStreaming);
   // Send the buffered data first.
   DCHECK_GT(bytes_remaining_in_buffer_, 0u);
   size_t start_position = buffered_body_.size() - bytes_remaining_in_buffer_;
@@ -366,6 +544,7 @@ void SpeedReaderURLLoader::Abort() {
   source_url_loader_.reset();
   source_url_client_receiver_.reset();
   destination_url_loader_client_.reset();
+  distiller_.reset();
   // |this| should be removed since the owner will destroy |this| or the owner
   // has already been destroyed by some reason.
 }
@@ -6,8 +6,10 @@
 #ifndef BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_URL_LOADER_H_
 #define BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_URL_LOADER_H_
 
+#include <memory>
 #include <string>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "base/callback.h"
@@ -20,6 +22,7 @@
 #include "mojo/public/cpp/bindings/receiver.h"
 #include "mojo/public/cpp/bindings/remote.h"
 #include "mojo/public/cpp/system/data_pipe.h"
+#include "mojo/public/cpp/system/data_pipe_drainer.h"
 #include "mojo/public/cpp/system/simple_watcher.h"
 #include "services/network/public/mojom/url_loader.mojom.h"
 #include "services/network/public/mojom/url_response_head.mojom-forward.h"
@@ -27,12 +30,27 @@
 namespace speedreader {
 
 class SpeedReaderThrottle;
+class SpeedreaderBodyDistiller;
+class SpeedreaderDistilledPageCache;
 class SpeedreaderRewriterService;
 
-// Loads the whole response body and tries to Speedreader-distill it.
+// Loads the response body and tries to Speedreader-distill it.
 // Cargoculted from |`SniffingURLLoader|.
 //
-// This loader has five states:
+// When |kSpeedreaderStreamingFeature| is enabled the body is distilled while it
+// is still arriving (see SpeedreaderBodyDistiller) and the loader goes
+// straight from kWaitForBody to kStreaming:
+// kStreaming: Receives the body from the source loader, feeds it to the
+//             distiller and sends the distiller's output to the destination
+//             loader client as soon as it is available. The state changes to
+//             kCompleted after the distiller is done and all output is sent.
+//
+// When a |distilled_page_cache| is given, the loader first looks the page up in
+// it and stays in kWaitForCache until the lookup finishes. On a hit the cached
+// page is sent through the kLoading -> kSending path without running the
+// rewriter, and the original body is drained and dropped.
+//
+// Otherwise the whole body is buffered first, and this loader has five states:
 // kWaitForBody: The initial state until the body is received (=
 //               OnStartLoadingResponseBody() is called) or the response is
 //               finished (= OnComplete() is called). When body is provided, the
@@ -51,7 +69,8 @@ class SpeedreaderRewriterService;
 //           the source loader to |this| are stopped. All incoming messages from
 //           the destination (through network::mojom::URLLoader) are ignored in
 class SpeedReaderURLLoader : public network::mojom::URLLoaderClient,
-                             public network::mojom::URLLoader {
+                             public network::mojom::URLLoader,
+                             public mojo::DataPipeDrainer::Client {
  public:
   ~SpeedReaderURLLoader() override;
 
@@ -72,7 +91,9 @@ class SpeedReaderURLLoader : public network::mojom::URLLoaderClient,
   CreateLoader(base::WeakPtr<SpeedReaderThrottle> throttle,
                const GURL& response_url,
                scoped_refptr<base::SingleThreadTaskRunner> task_runner,
-               SpeedreaderRewriterService* rewriter_service);
+               SpeedreaderRewriterService* rewriter_service,
+               SpeedreaderDistilledPageCache* distilled_page_cache,
+               const std::string& distilled_page_cache_key);
 
  private:
   SpeedReaderURLLoader(base::WeakPtr<SpeedReaderThrottle> throttle,
@@ -80,7 +101,9 @@ class SpeedReaderURLLoader : public network::mojom::URLLoaderClient,
                        mojo::PendingRemote<network::mojom::URLLoaderClient>
                            destination_url_loader_client,
                        scoped_refptr<base::SingleThreadTaskRunner> task_runner,
-                       SpeedreaderRewriterService* rewriter_service);
+                       SpeedreaderRewriterService* rewriter_service,
+                       SpeedreaderDistilledPageCache* distilled_page_cache,
+                       const std::string& distilled_page_cache_key);
 
   // network::mojom::URLLoaderClient implementation (called from the source of
   // the response):
@@ -110,9 +133,21 @@ class SpeedReaderURLLoader : public network::mojom::URLLoaderClient,
   void PauseReadingBodyFromNet() override;
   void ResumeReadingBodyFromNet() override;
 
+  // mojo::DataPipeDrainer::Client implementation (drains the original body
+  // when the page is served from the distilled page cache):
+  void OnDataAvailable(const void* data, size_t num_bytes) override;
+  void OnDataComplete() override;
+
   void OnBodyReadable(MojoResult);
   void OnBodyWritable(MojoResult);
+  void StartDistilling();
   void MaybeLaunchSpeedreader();
+  void StartStreaming();
+  void OnDistillerOutput(std::string data);
+  void OnDistillerComplete(bool distilled);
+  void OnDistilled(std::pair<std::string, bool> result);
+  void OnCacheLookup(base::Optional<std::string> distilled);
+  void ServeFromCache();
 
   // Gets either distilled or untouched body.
   void CompleteLoading(std::string body);
@@ -132,7 +167,15 @@ class SpeedReaderURLLoader : public network::mojom::URLLoaderClient,
 
   scoped_refptr<base::SingleThreadTaskRunner> task_runner_;
 
-  enum class State { kWaitForBody, kLoading, kSending, kCompleted, kAborted };
+  enum class State {
+    kWaitForBody,
+    kWaitForCache,
+    kLoading,
+    kSending,
+    kStreaming,
+    kCompleted,
+    kAborted
+  };
   State state_ = State::kWaitForBody;
 
   // Set if OnComplete() is called during distilling.
@@ -140,7 +183,22 @@ class SpeedReaderURLLoader : public network::mojom::URLLoaderClient,
 
   // Note that this could be replaced by a distilled version.
   std::string buffered_body_;
-  size_t bytes_remaining_in_buffer_;
+  size_t bytes_remaining_in_buffer_ = 0;
+
+  // Only used in the kStreaming state.
+  std::unique_ptr<SpeedreaderBodyDistiller> distiller_;
+  bool distiller_complete_ = false;
+
+  // Not Owned. Null if the response can't be cached.
+  SpeedreaderDistilledPageCache* distilled_page_cache_;
+  const std::string distilled_page_cache_key_;
+  bool cache_lookup_pending_ = false;
+  // Set on a cache hit until the body is available.
+  base::Optional<std::string> cached_body_;
+  // Distilled output streamed so far, to be stored in the cache.
+  std::string streamed_output_;
+  std::unique_ptr<mojo::DataPipeDrainer> body_drainer_;
+  size_t drained_bytes_ = 0;
 
   mojo::ScopedDataPipeConsumerHandle body_consumer_handle_;
   mojo::ScopedDataPipeProducerHandle body_producer_handle_;